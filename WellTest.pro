@@ -27,14 +27,28 @@ win32: LIBS += -lm
 
 # Input
 HEADERS += dataeditorwidget.h \
+           besselfunctions.h \
+           cancellationtoken.h \
            chartsetting1.h \
+           compositemodelsolver.h \
+           dimensionlesscurve.h \
+           dualnumber.h \
+           fittingjobdialog.h \
+           fittingjobscheduler.h \
            fittingobserveddata.h \
            fittingpage.h \
            fittingparameterchart.h \
+           laplaceinversion.h \
+           latestvaluebuffer.h \
+           logtimeresampler.h \
+           modelcomparisondialog.h \
+           modelcurvecache.h \
            modelmanager.h \
            modelparameter.h \
+           modelparams.h \
            modelselect.h \
            modelwidget01-06.h \
+           monotonecubicinterpolator.h \
            mousezoom.h \
            newprojectdialog.h \
            paramselectdialog.h \
@@ -44,6 +58,7 @@ HEADERS += dataeditorwidget.h \
            monitostatew.h \
            navbtn.h \
            pressurederivativecalculator.h \
+           reservoirresponsecache.h \
            settingswidget.h \
            qcustomplot.h \
            wt_fittingwidget.h \
@@ -51,7 +66,9 @@ HEADERS += dataeditorwidget.h \
 
 FORMS += dataeditorwidget.ui \
          chartsetting1.ui \
+         fittingjobdialog.ui \
          fittingpage.ui \
+         modelcomparisondialog.ui \
          modelselect.ui \
          modelwidget01-06.ui \
          newprojectdialog.ui \
@@ -66,15 +83,26 @@ FORMS += dataeditorwidget.ui \
          wt_projectwidget.ui
 
 SOURCES += \
+           besselfunctions.cpp \
            chartsetting1.cpp \
+           compositemodelsolver.cpp \
            dataeditorwidget.cpp \
+           dimensionlesscurve.cpp \
+           fittingjobdialog.cpp \
+           fittingjobscheduler.cpp \
            fittingobserveddata.cpp \
            fittingpage.cpp \
            fittingparameterchart.cpp \
+           laplaceinversion.cpp \
+           logtimeresampler.cpp \
+           modelcomparisondialog.cpp \
+           modelcurvecache.cpp \
            modelmanager.cpp \
            modelparameter.cpp \
+           modelparams.cpp \
            modelselect.cpp \
            modelwidget01-06.cpp \
+           monotonecubicinterpolator.cpp \
            mousezoom.cpp \
            newprojectdialog.cpp \
            paramselectdialog.cpp \
@@ -86,6 +114,7 @@ SOURCES += \
            monitostatew.cpp \
            navbtn.cpp \
            pressurederivativecalculator.cpp \
+           reservoirresponsecache.cpp \
            settingswidget.cpp \
            qcustomplot.cpp \
            wt_fittingwidget.cpp \
@@ -96,6 +125,9 @@ RESOURCES += resource.qrc
 INCLUDEPATH += D:/08YYYXXX/eigen-3.3.8
 INCLUDEPATH += D:/08YYYXXX/boost_1_89_0
 
+# 单元测试与基准测试 (独立的 qmake 工程，只依赖 Qt Core):
+# tests/tst_compositemodelsolver/tst_compositemodelsolver.pro
+
 
 # 警告设置
 QMAKE_CXXFLAGS_WARN_ON += -Wno-unused-parameter
@@ -0,0 +1,533 @@
+/*
+ * besselfunctions.cpp
+ * 文件作用：修正 Bessel 函数工具实现
+ * 功能描述：
+ * 1. 复宗量 K0, K1, I0, I1 的指数缩放值，分三个区间计算:
+ *    幂级数 (|z| <= 2)、连分式 (2 < |z| <= 25)、Hankel 渐近展开 (|z| > 25)
+ * 2. 参考: Numerical Recipes 6.7 (bessik, Steed 法)，DLMF 10.31 / 10.40
+ * 3. 实宗量 K0, K1, I0, I1 的融合计算与批量接口 (见下方 "实宗量" 部分)
+ *    Chebyshev 系数由 50 位精度的参考值在 Chebyshev 节点上插值得到，截断误差 < 1e-17 (相对)
+ * 4. K0, I0 的累积积分 (逐项积分的幂级数 + 尾部 Chebyshev 展开)，
+ *    尾积分参考值由 ∫_u^∞ K0 = ∫_0^∞ e^{-u cosh t}/cosh t dt 的梯形公式得到
+ */
+
+#include "besselfunctions.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+constexpr double kEulerGamma = 0.57721566490153286061;
+const double kEps = 1e-16;
+const int kMaxIter = 10000;
+
+// ----------------------------------------------------------------------------
+// 实宗量幂级数系数 (编译期计算)，q = x^2/4:
+// I0 = sum a_k q^k, I1 = (x/2) sum b_k q^k
+// K0 = -(ln(x/2)+γ) I0 + sum c_k q^k, K1 = 1/x + ln(x/2) I1 - (x/4) sum d_k q^k
+// a_k = 1/(k!)^2, b_k = 1/(k!(k+1)!), c_k = H_k a_k, d_k = (ψ(k+1)+ψ(k+2)) b_k
+// 逐项积分 (∫_0^u s^2k ln(s/2) ds = u^(2k+1)/(2k+1) [ln(u/2) - 1/(2k+1)]):
+// ∫_0^u I0 = u sum e_k q^k
+// ∫_0^u K0 = u [-(ln(u/2)+γ) sum e_k q^k + sum f_k q^k + sum g_k q^k]
+// e_k = a_k/(2k+1), f_k = a_k/(2k+1)^2, g_k = c_k/(2k+1)
+// ----------------------------------------------------------------------------
+constexpr int kSeriesTerms = 23; // x <= 8 (q <= 16) 时 I0, I1 的截断误差 < 1e-17
+constexpr int kSmallTerms = 13;  // x <= 2 (q <= 1) 时四个级数的截断误差 < 1e-19
+constexpr double kSmallLimit = 2.0;
+constexpr double kMidLimit = 8.0;
+
+struct SeriesTable {
+    double a[kSeriesTerms];
+    double b[kSeriesTerms];
+    double c[kSeriesTerms];
+    double d[kSeriesTerms];
+    double e[kSeriesTerms];
+    double f[kSeriesTerms];
+    double g[kSeriesTerms];
+};
+
+constexpr SeriesTable buildSeries()
+{
+    SeriesTable s{};
+    double a = 1.0, b = 1.0, H = 0.0;
+    for (int k = 0; k < kSeriesTerms; ++k) {
+        if (k > 0) {
+            a /= double(k) * k;
+            b /= double(k) * (k + 1);
+            H += 1.0 / k;
+        }
+        s.a[k] = a;
+        s.b[k] = b;
+        s.c[k] = H * a;
+        s.d[k] = (2.0 * H + 1.0 / (k + 1) - 2.0 * kEulerGamma) * b;
+        s.e[k] = a / (2 * k + 1);
+        s.f[k] = a / ((2.0 * k + 1) * (2 * k + 1));
+        s.g[k] = H * a / (2 * k + 1);
+    }
+    return s;
+}
+
+constexpr SeriesTable series = buildSeries();
+
+// ----------------------------------------------------------------------------
+// Chebyshev 展开系数 (首项已除以 2): f(t) = sum c_k T_k(t)
+// ----------------------------------------------------------------------------
+// sqrt(x) e^x K0(x)，x > 2，t = 4/x - 1
+const double kChebK0[26] = {
+    1.22015154103297774e+00, -3.14481013119645020e-02, 1.56988388573005332e-03,
+    -1.28495495816278017e-04, 1.39498137188765002e-05, -1.83175552271911953e-06,
+    2.76681363944501486e-07, -4.66048989768794783e-08, 8.57403401741422527e-09,
+    -1.69753450938906142e-09, 3.57739728140032832e-10, -7.95748924447739648e-11,
+    1.85594911495492645e-11, -4.51459788337451925e-12, 1.14034058820734414e-12,
+    -2.98009692314817842e-13, 8.03289077506837463e-14, -2.22751332674629647e-14,
+    6.34007647627664606e-15, -1.84859337792090710e-15, 5.51205599940433350e-16,
+    -1.67823112575490059e-16, 5.21039177764355432e-17, -1.64758059398426321e-17,
+    5.30043377117733540e-18, -1.73317120058210011e-18
+};
+// sqrt(x) e^x K1(x)，x > 2，t = 4/x - 1
+const double kChebK1[26] = {
+    1.36031309524222133e+00, 1.03923736576817236e-01, -2.85781685962277921e-03,
+    1.95215518471351620e-04, -1.93619797416608301e-05, 2.40648494783721699e-06,
+    -3.50196060308781256e-07, 5.74108412545004947e-08, -1.03457624656780968e-08,
+    2.01504975519703466e-09, -4.19035475934192542e-10, 9.21831518760531460e-11,
+    -2.12996783842779092e-11, 5.13963967348234321e-12, -1.28917396094982285e-12,
+    3.34841966605224312e-13, -8.97670518201014629e-14, 2.47715442421959878e-14,
+    -7.01983708921476847e-15, 2.03870316623986097e-15, -6.05704727064301766e-16,
+    1.83809357524304548e-16, -5.68946284919364841e-17, 1.79405104788635718e-17,
+    -5.75674448207330252e-18, 1.87786519016232677e-18
+};
+// sqrt(x) e^-x I0(x)，x > 8，t = 16/x - 1
+const double kChebI0[27] = {
+    4.02245205507054393e-01, 3.36911647825569429e-03, 6.88975834691682454e-05,
+    2.89137052083475665e-06, 2.04891858946906384e-07, 2.26666899049817804e-08,
+    3.39623202570838651e-09, 4.94060238822497006e-10, 1.18891471078464390e-11,
+    -3.14991652796324165e-11, -1.32158118404477133e-11, -1.79417853150680615e-12,
+    7.18012445138366601e-13, 3.85277838274214259e-13, 1.54008621752140996e-14,
+    -4.15056934728722224e-14, -9.55484669882830731e-15, 3.81168066935262240e-15,
+    1.77256013305652631e-15, -3.42548561967721900e-16, -2.82762398051658365e-16,
+    3.46122286769746122e-17, 4.46562142029675975e-17, -4.83050448594418188e-18,
+    -7.23318048787475380e-18, 9.92147541217369872e-19, 1.19365089084598204e-18
+};
+// sqrt(x) e^-x I1(x)，x > 8，t = 16/x - 1
+const double kChebI1[27] = {
+    3.89288117509140053e-01, -9.76109749136146870e-03, -1.10588938762623713e-04,
+    -3.88256480887769059e-06, -2.51223623787020884e-07, -2.63146884688951959e-08,
+    -3.83538038596423700e-09, -5.58974346219658378e-10, -1.89749581235054126e-11,
+    3.25260358301548844e-11, 1.41258074366137819e-11, 2.03562854414708956e-12,
+    -7.19855177624590836e-13, -4.08355111109219740e-13, -2.10154184277266430e-14,
+    4.27244001671195105e-14, 1.04202769841288021e-14, -3.81440307243700754e-15,
+    -1.88035477551078251e-15, 3.30820231092092852e-16, 2.96262899764595008e-16,
+    -3.20952592199342376e-17, -4.65030536848935863e-17, 4.41434832307170765e-18,
+    7.51729631084210521e-18, -9.31417886732688422e-19, -1.24219327519489097e-18
+};
+
+// sqrt(u) e^u ∫_u^∞ K0(s) ds，u > 2，t = 4/u - 1
+const double kChebTailK0[38] = {
+    1.12067802749865253e+00, -1.17154590698505479e-01, 1.30369702368230266e-02,
+    -1.98067618213532831e-03, 3.63768787789326439e-04, -7.62990307184891766e-05,
+    1.76914075264367608e-05, -4.44125996337404369e-06, 1.18992121955505352e-06,
+    -3.36728278748512241e-07, 9.98585047187354030e-08, -3.08453824760775996e-08,
+    9.87622644070719371e-09, -3.26497831821630536e-09, 1.11083357639133297e-09,
+    -3.87898255892946493e-10, 1.38703537451260101e-10, -5.06876730622417698e-11,
+    1.88982878753083140e-11, -7.17799139172347413e-12, 2.77381426871197404e-12,
+    -1.08929379345394130e-12, 4.34270637431509396e-13, -1.75600326453034521e-13,
+    7.19584025025788532e-14, -2.98610943236829425e-14, 1.25402082962118961e-14,
+    -5.32612948412640254e-15, 2.28656111253079715e-15, -9.91732500410679398e-16,
+    4.34351614001214287e-16, -1.92014499227635573e-16, 8.56440347003902565e-17,
+    -3.85272798437174692e-17, 1.74741816070797123e-17, -7.98807492461680141e-18,
+    3.67936704770811716e-18, -1.70713252434357430e-18
+};
+// sqrt(u) e^-u ∫_0^u I0(s) ds，u > 8，t = 16/u - 1
+const double kChebIntI0[48] = {
+    4.18054055453544349e-01, 2.05604061652494702e-02, 1.64683920500791644e-03,
+    2.21618174039931560e-04, 1.88730333896472046e-05, -8.36297027808788325e-06,
+    -4.47137191270818884e-06, -3.38677663837521567e-07, 4.42736474961645532e-07,
+    1.08293897294476907e-07, -5.01026712346889537e-08, -1.84798239148015558e-08,
+    7.68418292356716801e-09, 2.81566612855241571e-09, -1.52414501527402258e-09,
+    -3.55652410298428609e-10, 3.35330213094753339e-10, 1.47685300949086152e-11,
+    -7.07606948795409092e-11, 1.23805031042939687e-11, 1.22012384574621980e-11,
+    -6.00201851651390630e-12, -1.02112561733886502e-12, 1.71103395512396191e-12,
+    -3.27160177094315128e-13, -2.99079407485492275e-13, 1.91878797435627894e-13,
+    5.53082767379927187e-16, -4.93857149784317097e-14, 2.07679337503944690e-14,
+    3.95079241009384211e-15, -7.38196271611880677e-15, 2.38976255135186575e-15,
+    8.86068344479124040e-16, -1.11162851674821433e-15, 3.16678064887891529e-16,
+    1.53801139949463348e-16, -1.74791342414500845e-16, 5.06641873656446784e-17,
+    2.36499961337610194e-17, -2.87884302958232470e-17, 9.60005541598932538e-18,
+    3.14197806927893130e-18, -4.87847634004818144e-18, 2.01554880428871018e-18,
+    2.82586864707395451e-19, -8.21970819562288073e-19, 4.38374336206980848e-19
+};
+
+// 一次批量计算的节点数上限 (一个 15 点 Gauss 面板可一次算完)
+const int kBlock = 16;
+
+// 标量 Horner / Clenshaw 求值 (单点调用)
+inline double polynomial(const double* c, int m, double q)
+{
+    double s = c[m - 1];
+    for (int k = m - 2; k >= 0; --k) s = s * q + c[k];
+    return s;
+}
+
+template<int N>
+inline double chebyshev(const double (&c)[N], double t)
+{
+    double b1 = 0.0, b2 = 0.0, t2 = 2.0 * t;
+    for (int k = N - 1; k >= 1; --k) {
+        double b0 = t2 * b1 - b2 + c[k];
+        b2 = b1;
+        b1 = b0;
+    }
+    return t * b1 - b2 + c[0];
+}
+
+// 批量 Horner 求值 sum_{k<m} c_k q^k，节点在内层循环
+inline void polynomialBlock(const double* c, int m, const double* q, int n, double* out)
+{
+    for (int l = 0; l < n; ++l) out[l] = c[m - 1];
+    for (int k = m - 2; k >= 0; --k) {
+        const double ck = c[k];
+        for (int l = 0; l < n; ++l) out[l] = out[l] * q[l] + ck;
+    }
+}
+
+// 批量 Clenshaw 求值 sum c_k T_k(t)，节点在内层循环
+template<int N>
+inline void chebyshevBlock(const double (&c)[N], const double* t, int n, double* out)
+{
+    double b1[kBlock], b2[kBlock], t2[kBlock];
+    for (int l = 0; l < n; ++l) { b1[l] = 0.0; b2[l] = 0.0; t2[l] = 2.0 * t[l]; }
+    for (int k = N - 1; k >= 1; --k) {
+        const double ck = c[k];
+        for (int l = 0; l < n; ++l) {
+            double b0 = t2[l] * b1[l] - b2[l] + ck;
+            b2[l] = b1[l];
+            b1[l] = b0;
+        }
+    }
+    for (int l = 0; l < n; ++l) out[l] = t[l] * b1[l] - b2[l] + c[0];
+}
+
+// 由级数/展开和得到缩放值 (单点与批量共用)
+// x <= 2: 四个函数共享 ln(x/2) 与 e^x
+template<bool Order1>
+inline void finishSmall(double x, double sI0, double sK0, double sI1, double sK1,
+                        double& k0s, double* k1s, double& i0s, double* i1s)
+{
+    double lnHalf = std::log(0.5 * x);
+    double ex = std::exp(x);
+    k0s = (-(lnHalf + kEulerGamma) * sI0 + sK0) * ex;
+    i0s = sI0 / ex;
+    if (Order1) {
+        double I1 = 0.5 * x * sI1;
+        *k1s = (1.0 / x + lnHalf * I1 - 0.25 * x * sK1) * ex;
+        *i1s = I1 / ex;
+    }
+}
+
+// 2 < x <= 8: K 为 Chebyshev 展开 (乘 1/sqrt(x))，I 为幂级数 (乘 e^-x)
+template<bool Order1>
+inline void finishMid(double x, double cK0, double sI0, double cK1, double sI1,
+                      double& k0s, double* k1s, double& i0s, double* i1s)
+{
+    double rs = 1.0 / std::sqrt(x);
+    double emx = std::exp(-x);
+    k0s = cK0 * rs;
+    i0s = sI0 * emx;
+    if (Order1) {
+        *k1s = cK1 * rs;
+        *i1s = 0.5 * x * sI1 * emx;
+    }
+}
+
+// x > 8: 四个函数均为 Chebyshev 展开 (乘 1/sqrt(x))，不需要指数函数
+template<bool Order1>
+inline void finishLarge(double x, double cK0, double cI0, double cK1, double cI1,
+                        double& k0s, double* k1s, double& i0s, double* i1s)
+{
+    double rs = 1.0 / std::sqrt(x);
+    k0s = cK0 * rs;
+    i0s = cI0 * rs;
+    if (Order1) {
+        *k1s = cK1 * rs;
+        *i1s = cI1 * rs;
+    }
+}
+
+// 批量区间内核: 先对全部节点同时求各级数/展开和，再逐点得到缩放值
+template<bool Order1>
+void smallRegion(const double* x, int n, double* k0s, double* k1s, double* i0s, double* i1s)
+{
+    double q[kBlock], sI0[kBlock], sK0[kBlock], sI1[kBlock] = {}, sK1[kBlock] = {};
+    for (int l = 0; l < n; ++l) q[l] = 0.25 * x[l] * x[l];
+    polynomialBlock(series.a, kSmallTerms, q, n, sI0);
+    polynomialBlock(series.c, kSmallTerms, q, n, sK0);
+    if (Order1) {
+        polynomialBlock(series.b, kSmallTerms, q, n, sI1);
+        polynomialBlock(series.d, kSmallTerms, q, n, sK1);
+    }
+    for (int l = 0; l < n; ++l) finishSmall<Order1>(x[l], sI0[l], sK0[l], sI1[l], sK1[l], k0s[l], k1s + l, i0s[l], i1s + l);
+}
+
+template<bool Order1>
+void midRegion(const double* x, int n, double* k0s, double* k1s, double* i0s, double* i1s)
+{
+    double t[kBlock], q[kBlock], cK0[kBlock], sI0[kBlock], cK1[kBlock] = {}, sI1[kBlock] = {};
+    for (int l = 0; l < n; ++l) {
+        t[l] = 4.0 / x[l] - 1.0;
+        q[l] = 0.25 * x[l] * x[l];
+    }
+    chebyshevBlock(kChebK0, t, n, cK0);
+    polynomialBlock(series.a, kSeriesTerms, q, n, sI0);
+    if (Order1) {
+        chebyshevBlock(kChebK1, t, n, cK1);
+        polynomialBlock(series.b, kSeriesTerms, q, n, sI1);
+    }
+    for (int l = 0; l < n; ++l) finishMid<Order1>(x[l], cK0[l], sI0[l], cK1[l], sI1[l], k0s[l], k1s + l, i0s[l], i1s + l);
+}
+
+template<bool Order1>
+void largeRegion(const double* x, int n, double* k0s, double* k1s, double* i0s, double* i1s)
+{
+    double tK[kBlock], tI[kBlock], cK0[kBlock], cI0[kBlock], cK1[kBlock] = {}, cI1[kBlock] = {};
+    for (int l = 0; l < n; ++l) {
+        tK[l] = 4.0 / x[l] - 1.0;
+        tI[l] = 16.0 / x[l] - 1.0;
+    }
+    chebyshevBlock(kChebK0, tK, n, cK0);
+    chebyshevBlock(kChebI0, tI, n, cI0);
+    if (Order1) {
+        chebyshevBlock(kChebK1, tK, n, cK1);
+        chebyshevBlock(kChebI1, tI, n, cI1);
+    }
+    for (int l = 0; l < n; ++l) finishLarge<Order1>(x[l], cK0[l], cI0[l], cK1[l], cI1[l], k0s[l], k1s + l, i0s[l], i1s + l);
+}
+
+// 按区间把节点收集为连续数组，分区间计算后写回原位置
+template<bool Order1>
+void realBatch(const double* x, int n, double* k0s, double* k1s, double* i0s, double* i1s)
+{
+    typedef void (*RegionKernel)(const double*, int, double*, double*, double*, double*);
+    static const RegionKernel kernels[3] = { smallRegion<Order1>, midRegion<Order1>, largeRegion<Order1> };
+
+    for (int begin = 0; begin < n; begin += kBlock) {
+        int count = std::min(kBlock, n - begin);
+        int index[3][kBlock];
+        int size[3] = { 0, 0, 0 };
+        for (int l = 0; l < count; ++l) {
+            double v = x[begin + l];
+            int region = (v <= kSmallLimit) ? 0 : (v <= kMidLimit ? 1 : 2);
+            index[region][size[region]++] = begin + l;
+        }
+        for (int r = 0; r < 3; ++r) {
+            int m = size[r];
+            if (m == 0) continue;
+            double xg[kBlock], k0g[kBlock], k1g[kBlock], i0g[kBlock], i1g[kBlock];
+            for (int l = 0; l < m; ++l) xg[l] = x[index[r][l]];
+            kernels[r](xg, m, k0g, k1g, i0g, i1g);
+            for (int l = 0; l < m; ++l) {
+                int i = index[r][l];
+                k0s[i] = k0g[l];
+                i0s[i] = i0g[l];
+                if (Order1) {
+                    k1s[i] = k1g[l];
+                    i1s[i] = i1g[l];
+                }
+            }
+        }
+    }
+}
+}
+
+void BesselFunctions::scaledKI(const Complex& z, Complex& k0s, Complex& k1s, Complex& i0s, Complex& i1s)
+{
+    double az = std::abs(z);
+    if (az <= 2.0) seriesKI(z, k0s, k1s, i0s, i1s);
+    else if (az <= 25.0) continuedFractionKI(z, k0s, k1s, i0s, i1s);
+    else asymptoticKI(z, k0s, k1s, i0s, i1s);
+}
+
+void BesselFunctions::seriesKI(const Complex& z, Complex& k0s, Complex& k1s, Complex& i0s, Complex& i1s)
+{
+    // DLMF 10.25.2 / 10.31.1:
+    // I0 = sum q^k/(k!)^2, I1 = (z/2) sum q^k/(k!(k+1)!), q = z^2/4
+    // K0 = -(ln(z/2)+γ) I0 + sum H_k q^k/(k!)^2
+    // K1 = 1/z + ln(z/2) I1 - (z/4) sum (ψ(k+1)+ψ(k+2)) q^k/(k!(k+1)!)
+    Complex q = 0.25 * z * z;
+    Complex t0(1.0, 0.0);  // q^k/(k!)^2
+    Complex t1(1.0, 0.0);  // q^k/(k!(k+1)!)
+    Complex sI0 = t0, sI1 = t1, sK0(0.0, 0.0);
+    Complex sK1 = (1.0 - 2.0 * kEulerGamma) * t1; // ψ(1)+ψ(2) = 1 - 2γ
+    double H = 0.0; // 调和数 H_k
+    for (int k = 1; k < 60; ++k) {
+        t0 *= q / double(k * k);
+        t1 *= q / double(k * (k + 1));
+        H += 1.0 / k;
+        double psiSum = 2.0 * H + 1.0 / (k + 1) - 2.0 * kEulerGamma;
+        sI0 += t0; sI1 += t1;
+        sK0 += H * t0;
+        sK1 += psiSum * t1;
+        if (std::abs(t0) < kEps * std::abs(sI0) && std::abs(t1) < kEps * std::abs(sI1)) break;
+    }
+    Complex lnHalf = std::log(0.5 * z);
+    Complex I0 = sI0;
+    Complex I1 = 0.5 * z * sI1;
+    Complex K0 = -(lnHalf + kEulerGamma) * I0 + sK0;
+    Complex K1 = 1.0 / z + lnHalf * I1 - 0.25 * z * sK1;
+
+    Complex ez = std::exp(z);
+    Complex emz = std::exp(-z);
+    k0s = K0 * ez; k1s = K1 * ez;
+    i0s = I0 * emz; i1s = I1 * emz;
+}
+
+void BesselFunctions::continuedFractionKI(const Complex& z, Complex& k0s, Complex& k1s, Complex& i0s, Complex& i1s)
+{
+    // --- K0, K1: Steed 法计算 CF2 (Numerical Recipes bessik, ν = 0) ---
+    Complex b = 2.0 * (1.0 + z);
+    Complex d = 1.0 / b;
+    Complex h = d, delh = d;
+    Complex q1(0.0, 0.0), q2(1.0, 0.0);
+    const double a1 = 0.25;
+    Complex qs(a1, 0.0), c(a1, 0.0);
+    double a = -a1;
+    Complex s = 1.0 + qs * delh;
+    for (int i = 2; i <= kMaxIter; ++i) {
+        a -= 2.0 * (i - 1);
+        c = -a * c / double(i);
+        Complex qnew = (q1 - b * q2) / a;
+        q1 = q2; q2 = qnew;
+        qs += c * qnew;
+        b += 2.0;
+        d = 1.0 / (b + a * d);
+        delh = (b * d - 1.0) * delh;
+        h += delh;
+        Complex dels = qs * delh;
+        s += dels;
+        if (std::abs(dels) < kEps * std::abs(s)) break;
+    }
+    h = a1 * h;
+    k0s = std::sqrt(M_PI / (2.0 * z)) / s;
+    k1s = k0s * (z + 0.5 - h) / z;
+
+    // --- I1/I0: 比值连分式 r = 1/(2/z + 1/(4/z + ...))，改进 Lentz 法 ---
+    const double tiny = 1e-300;
+    Complex f(tiny, 0.0), C = f, D(0.0, 0.0);
+    for (int j = 1; j <= kMaxIter; ++j) {
+        Complex bj = 2.0 * j / z;
+        D = bj + D; if (std::abs(D) < tiny) D = tiny;
+        C = bj + 1.0 / C; if (std::abs(C) < tiny) C = tiny;
+        D = 1.0 / D;
+        Complex delta = C * D;
+        f *= delta;
+        if (std::abs(delta - 1.0) < kEps) break;
+    }
+    // Wronski 关系 I0 K1 + I1 K0 = 1/z
+    i0s = 1.0 / (z * (k1s + f * k0s));
+    i1s = f * i0s;
+}
+
+void BesselFunctions::asymptoticKI(const Complex& z, Complex& k0s, Complex& k1s, Complex& i0s, Complex& i1s)
+{
+    // DLMF 10.40.2 / 10.40.5:
+    // K_ν(z)e^z ~ sqrt(π/2z) sum a_k(ν)/z^k
+    // I_ν(z)e^-z ~ [sum (-1)^k a_k(ν)/z^k ± i e^{±iνπ} e^-2z sum a_k(ν)/z^k] / sqrt(2πz)
+    // a_k(ν) = (4ν²-1)(4ν²-9)...(4ν²-(2k-1)²) / (k! 8^k)
+    Complex inv = 1.0 / z;
+    Complex t0(1.0, 0.0), t1(1.0, 0.0);
+    Complex s0p = t0, s0m = t0, s1p = t1, s1m = t1;
+    for (int k = 1; k < 40; ++k) {
+        double odd = (2.0 * k - 1.0) * (2.0 * k - 1.0);
+        t0 *= (0.0 - odd) * inv / (8.0 * k);
+        t1 *= (4.0 - odd) * inv / (8.0 * k);
+        double sign = (k % 2 == 0) ? 1.0 : -1.0;
+        s0p += t0; s0m += sign * t0;
+        s1p += t1; s1m += sign * t1;
+        if (std::abs(t0) < kEps * std::abs(s0p) && std::abs(t1) < kEps * std::abs(s1p)) break;
+    }
+    Complex kPre = std::sqrt(M_PI / (2.0 * z));
+    k0s = kPre * s0p;
+    k1s = kPre * s1p;
+
+    // 第二项在 Re z > 0 时指数小，仅在接近虚轴时起作用 (上半平面取 +，下半平面取 -)
+    Complex iPre = 1.0 / std::sqrt(2.0 * M_PI * z);
+    Complex stokes = (z.imag() >= 0.0 ? Complex(0.0, 1.0) : Complex(0.0, -1.0)) * std::exp(-2.0 * z);
+    i0s = iPre * (s0m + stokes * s0p);
+    i1s = iPre * (s1m - stokes * s1p);
+}
+
+// ============================================================================
+// 实宗量
+// ============================================================================
+
+void BesselFunctions::scaledKI(double x, double& k0s, double& k1s, double& i0s, double& i1s)
+{
+    // 单点调用不经过批量内核的分组与拷贝
+    if (x <= kSmallLimit) {
+        double q = 0.25 * x * x;
+        finishSmall<true>(x, polynomial(series.a, kSmallTerms, q), polynomial(series.c, kSmallTerms, q),
+                          polynomial(series.b, kSmallTerms, q), polynomial(series.d, kSmallTerms, q),
+                          k0s, &k1s, i0s, &i1s);
+    } else if (x <= kMidLimit) {
+        double t = 4.0 / x - 1.0;
+        double q = 0.25 * x * x;
+        finishMid<true>(x, chebyshev(kChebK0, t), polynomial(series.a, kSeriesTerms, q),
+                        chebyshev(kChebK1, t), polynomial(series.b, kSeriesTerms, q),
+                        k0s, &k1s, i0s, &i1s);
+    } else {
+        double tK = 4.0 / x - 1.0;
+        double tI = 16.0 / x - 1.0;
+        finishLarge<true>(x, chebyshev(kChebK0, tK), chebyshev(kChebI0, tI),
+                          chebyshev(kChebK1, tK), chebyshev(kChebI1, tI),
+                          k0s, &k1s, i0s, &i1s);
+    }
+}
+
+void BesselFunctions::scaledKI(const double* x, int n, double* k0s, double* k1s, double* i0s, double* i1s)
+{
+    realBatch<true>(x, n, k0s, k1s, i0s, i1s);
+}
+
+void BesselFunctions::scaledK0I0(const double* x, int n, double* k0s, double* i0s)
+{
+    realBatch<false>(x, n, k0s, nullptr, i0s, nullptr);
+}
+
+void BesselFunctions::scaledK0I0(const Complex* z, int n, Complex* k0s, Complex* i0s)
+{
+    // 复宗量的三个区间算法迭代次数各不相同，逐点计算
+    Complex k1s, i1s;
+    for (int l = 0; l < n; ++l) scaledKI(z[l], k0s[l], k1s, i0s[l], i1s);
+}
+
+double BesselFunctions::integralK0(double u)
+{
+    if (u <= 0.0) return 0.0;
+    if (u <= kSmallLimit) {
+        double q = 0.25 * u * u;
+        double lnHalf = std::log(0.5 * u);
+        return u * (-(lnHalf + kEulerGamma) * polynomial(series.e, kSmallTerms, q)
+                    + polynomial(series.f, kSmallTerms, q) + polynomial(series.g, kSmallTerms, q));
+    }
+    // ∫_0^∞ K0 = π/2
+    return 0.5 * M_PI - tailIntegralK0(u);
+}
+
+double BesselFunctions::tailIntegralK0(double u)
+{
+    if (u <= kSmallLimit) return 0.5 * M_PI - integralK0(u);
+    return chebyshev(kChebTailK0, 4.0 / u - 1.0) * std::exp(-u) / std::sqrt(u);
+}
+
+double BesselFunctions::scaledIntegralI0(double u)
+{
+    if (u <= 0.0) return 0.0;
+    if (u <= kMidLimit) {
+        double q = 0.25 * u * u;
+        return u * polynomial(series.e, kSeriesTerms, q) * std::exp(-u);
+    }
+    return chebyshev(kChebIntI0, 16.0 / u - 1.0) / std::sqrt(u);
+}
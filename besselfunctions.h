@@ -0,0 +1,54 @@
+/*
+ * besselfunctions.h
+ * 文件作用：修正 Bessel 函数工具头文件
+ * 功能描述：
+ * 1. 复宗量 0/1 阶修正 Bessel 函数 K0, K1, I0, I1 (Re z >= 0)，
+ *    供 Euler / Talbot / de Hoog 等需要在复平面上计算拉氏空间解的反演方法使用
+ * 2. 一次调用同时给出四个函数的指数缩放值，避免大宗量时上溢/下溢:
+ *    k0s = K0(z)e^z, k1s = K1(z)e^z, i0s = I0(z)e^-z, i1s = I1(z)e^-z
+ * 3. |z| <= 2 用幂级数，2 < |z| <= 25 用 Steed 连分式 (K) + 比值连分式与 Wronski 关系 (I)，
+ *    |z| > 25 用 Hankel 渐近展开
+ * 4. 实宗量专用实现 (Stehfest 实轴节点): 四个函数共享同一组幂级数 / Chebyshev 展开，
+ *    x <= 2 幂级数，2 < x <= 8 为 K 的 Chebyshev 展开 + I 的幂级数，x > 8 全部为 Chebyshev 展开 (变量 1/x)
+ * 5. 批量接口: 一次计算一个 Gauss 积分面板上的全部节点。节点按区间分组后，
+ *    以"系数外层、节点内层"的顺序求和，内层循环无分支，可由编译器自动向量化 (SIMD)
+ * 6. 累积积分 ∫_0^u K0 与 ∫_0^u I0 (实宗量)，裂缝段影响系数可由两次查表之差得到
+ */
+
+#ifndef BESSELFUNCTIONS_H
+#define BESSELFUNCTIONS_H
+
+#include <complex>
+
+class BesselFunctions
+{
+public:
+    typedef std::complex<double> Complex;
+
+    // 指数缩放的 K0, K1, I0, I1 (复宗量，要求 Re z >= 0 且 z != 0)
+    static void scaledKI(const Complex& z, Complex& k0s, Complex& k1s, Complex& i0s, Complex& i1s);
+
+    // 指数缩放的 K0, K1, I0, I1 (实宗量，要求 x > 0)
+    static void scaledKI(double x, double& k0s, double& k1s, double& i0s, double& i1s);
+
+    // 批量计算 n 个实宗量的缩放 K0, K1, I0, I1
+    static void scaledKI(const double* x, int n, double* k0s, double* k1s, double* i0s, double* i1s);
+
+    // 只需 0 阶函数时的批量版本 (积分核 K0 + Ac*I0)，省去 1 阶展开
+    static void scaledK0I0(const double* x, int n, double* k0s, double* i0s);
+    static void scaledK0I0(const Complex* z, int n, Complex* k0s, Complex* i0s);
+
+    // ∫_0^u K0(s) ds (u >= 0)，u -> ∞ 时趋于 π/2
+    static double integralK0(double u);
+    // 尾积分 ∫_u^∞ K0(s) ds (u > 0)，u 较大时比 π/2 - integralK0(u) 精确
+    static double tailIntegralK0(double u);
+    // 指数缩放的 ∫_0^u I0(s) ds * e^-u (u >= 0)
+    static double scaledIntegralI0(double u);
+
+private:
+    static void seriesKI(const Complex& z, Complex& k0s, Complex& k1s, Complex& i0s, Complex& i1s);
+    static void continuedFractionKI(const Complex& z, Complex& k0s, Complex& k1s, Complex& i0s, Complex& i1s);
+    static void asymptoticKI(const Complex& z, Complex& k0s, Complex& k1s, Complex& i0s, Complex& i1s);
+};
+
+#endif // BESSELFUNCTIONS_H
@@ -0,0 +1,83 @@
+/*
+ * cancellationtoken.h
+ * 文件作用：协作式取消令牌
+ * 功能描述：
+ * 1. 界面线程调用 cancel() 请求取消，计算线程在循环中轮询 isCancelled() 后尽快返回
+ * 2. 可附带时限 (墙钟时间)，到期后与主动取消同样处理，reason() 区分两者
+ * 3. 令牌按值传递、共享同一状态；默认构造的令牌永不取消，轮询只是一次空指针判断
+ * 4. 派生令牌随原令牌一起取消，另有自己的时限 (如排队任务开始运行后才计时的拟合时限)
+ * 5. 被取消的计算结果不完整，调用方不应使用或缓存
+ */
+
+#ifndef CANCELLATIONTOKEN_H
+#define CANCELLATIONTOKEN_H
+
+#include <QAtomicInt>
+#include <QDeadlineTimer>
+#include <QSharedPointer>
+
+class CancellationToken
+{
+public:
+    enum Reason { NotCancelled = 0, Requested, DeadlineExpired };
+
+    CancellationToken() {}
+
+    // 创建可取消的令牌；timeoutMs < 0 表示不限时
+    static CancellationToken create(qint64 timeoutMs = -1)
+    {
+        CancellationToken token;
+        token.m_state.reset(new State(timeoutMs));
+        return token;
+    }
+
+    // 派生令牌: 本令牌取消时随之取消 (原因相同)，另在 timeoutMs 之后到期 (从调用时起计)
+    CancellationToken withTimeout(qint64 timeoutMs) const
+    {
+        CancellationToken token = create(timeoutMs);
+        token.m_state->parent = m_state;
+        return token;
+    }
+
+    void cancel() const
+    {
+        if (m_state) m_state->reason.testAndSetRelaxed(NotCancelled, Requested);
+    }
+
+    // 取消一经发生即保持 (时限到期也记为取消)
+    bool isCancelled() const
+    {
+        return m_state && m_state->isCancelled();
+    }
+
+    Reason reason() const
+    {
+        return isCancelled() ? Reason(m_state->reason.loadRelaxed()) : NotCancelled;
+    }
+
+private:
+    struct State {
+        QAtomicInt reason;
+        QDeadlineTimer deadline;
+        QSharedPointer<State> parent; // 派生令牌的原令牌
+
+        explicit State(qint64 timeoutMs)
+            : reason(NotCancelled),
+              deadline(timeoutMs < 0 ? QDeadlineTimer(QDeadlineTimer::Forever) : QDeadlineTimer(timeoutMs)) {}
+
+        bool isCancelled()
+        {
+            if (reason.loadRelaxed() != NotCancelled) return true;
+            if (parent && parent->isCancelled()) {
+                reason.testAndSetRelaxed(NotCancelled, parent->reason.loadRelaxed());
+                return true;
+            }
+            if (!deadline.hasExpired()) return false;
+            reason.testAndSetRelaxed(NotCancelled, DeadlineExpired);
+            return true;
+        }
+    };
+    QSharedPointer<State> m_state;
+};
+
+#endif // CANCELLATIONTOKEN_H
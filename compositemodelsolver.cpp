@@ -0,0 +1,1169 @@
+/*
+ * compositemodelsolver.cpp
+ * 文件作用：压裂水平井复合页岩油模型 (模型1-6) 的无界面求解器实现
+ * 功能描述：
+ * 1. Model 1/2: 无限大边界 (对应 MATLAB: mAB=0)
+ * 2. Model 3/4: 封闭边界 (对应 MATLAB: mAB=K1/I1)
+ * 3. Model 5/6: 定压边界 (对应 MATLAB: mAB=-K0/I0)
+ * 4. 奇数模型考虑变井储表皮 (对应 MATLAB: CD/S non-zero)，偶数模型为恒定井储
+ * 5. 拉氏空间解按标量类型模板化: Stehfest 在实轴上用 double 计算，
+ *    Euler / Talbot / de Hoog 在复平面上用 std::complex<double> 计算
+ * 6. 数值反演循环按节点组分块，通过 QtConcurrent::blockingMap 在指定线程池中并行执行
+ * 7. 实数影响系数: 自身/相邻裂缝段由 ∫K0、∫I0 累积积分表两次查表相减得到，远处段用 8 点 Gauss 积分，
+ *    热路径中不再有自适应递归积分
+ * 8. 参数以定长索引的 ModelParams 传入，一条曲线内不变的拉氏空间参数与裂缝位置只准备一次，
+ *    拉氏空间求值中不做字符串查找，等间距裂缝的求解不分配堆内存
+ * 9. 拉氏空间解按 (外边界类型, 是否变井储) 在编译期特化，每条曲线只按模型类型分派一次，
+ *    循环内没有运行期的模型判断；无限大边界的实例不含 reD 处的贝塞尔函数计算
+ * 10. 粗网格模式: 对数网格逐层二分加密，在 (ln t, ln p) 空间用保单调三次插值映射到观测时间
+ * 11. 压力导数 tD*dpD/dtD 由 z*p(z) 在同一组拉氏空间节点值上反演得到，不再额外求值，
+ *     也不依赖时间网格疏密 (替代对反演压力做 Bourdet 数值微分)
+ * 12. 储层响应 p̄wD(z) 按 (储层参数, 时间换算系数, 反演节点) 缓存，井储表皮与压敏变换在其上重新施加
+ * 13. 前向自动微分: 拉氏空间解与影响系数、贝塞尔函数、累积积分表、Toeplitz/LU 求解均对对偶数实例化，
+ *     已知导数的特殊函数 (K0' = -K1, I0' = I1, d∫K0 = K0 ...) 直接组装对偶数；
+ *     各方向的导数像与压力共用同一组反演系数，得到数值反演曲线的精确偏导数
+ *
+ * 线程安全说明：
+ * 所有成员函数均为 const 或 static，计算过程中只使用局部变量，
+ * 唯一共享的储层响应缓存内部加锁，同一个求解器实例可被多个线程同时调用。
+ */
+
+#include "compositemodelsolver.h"
+#include "besselfunctions.h"
+#include "monotonecubicinterpolator.h"
+#include "reservoirresponsecache.h"
+
+#include <QPair>
+#include <QVarLengthArray>
+#include <QtConcurrent>
+#include <Eigen/Dense>
+
+#include <cmath>
+#include <algorithm>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+// 特殊函数的统一入口: double / Complex 直接调用 BesselFunctions，对偶数按已知导数公式组装
+// 缩放函数的导数: (K0 e^x)' = k0s - k1s, (K1 e^x)' = k1s - k0s - k1s/x, (I0 e^-x)' = i1s - i0s, (I1 e^-x)' = i0s - i1s/x - i1s
+void scaledBesselKI(double x, double& k0s, double& k1s, double& i0s, double& i1s)
+{
+    BesselFunctions::scaledKI(x, k0s, k1s, i0s, i1s);
+}
+
+void scaledBesselKI(const std::complex<double>& z, std::complex<double>& k0s, std::complex<double>& k1s,
+                    std::complex<double>& i0s, std::complex<double>& i1s)
+{
+    BesselFunctions::scaledKI(z, k0s, k1s, i0s, i1s);
+}
+
+template<typename S, int N>
+void scaledBesselKI(const DualNumber<S, N>& x, DualNumber<S, N>& k0s, DualNumber<S, N>& k1s,
+                    DualNumber<S, N>& i0s, DualNumber<S, N>& i1s)
+{
+    typedef DualNumber<S, N> D;
+    S a, b, c, d;
+    BesselFunctions::scaledKI(x.value(), a, b, c, d);
+    S v = x.value();
+    k0s = D::compose(x, a, a - b);
+    k1s = D::compose(x, b, b - a - b / v);
+    i0s = D::compose(x, c, d - c);
+    i1s = D::compose(x, d, c - d / v - d);
+}
+
+void scaledBesselK0I0(const double* x, int n, double* k0s, double* i0s)
+{
+    BesselFunctions::scaledK0I0(x, n, k0s, i0s);
+}
+
+void scaledBesselK0I0(const std::complex<double>* z, int n, std::complex<double>* k0s, std::complex<double>* i0s)
+{
+    BesselFunctions::scaledK0I0(z, n, k0s, i0s);
+}
+
+template<typename S, int N>
+void scaledBesselK0I0(const DualNumber<S, N>* x, int n, DualNumber<S, N>* k0s, DualNumber<S, N>* i0s)
+{
+    // 导数需要 1 阶函数，逐点计算完整的四个函数
+    DualNumber<S, N> k1s, i1s;
+    for (int i = 0; i < n; ++i) scaledBesselKI(x[i], k0s[i], k1s, i0s[i], i1s);
+}
+
+// ∫_0^u K0，导数为 K0(u)
+double integralK0(double u)
+{
+    return BesselFunctions::integralK0(u);
+}
+
+template<int N>
+DualNumber<double, N> integralK0(const DualNumber<double, N>& u)
+{
+    double v = u.value();
+    double k0 = 0.0;
+    if (v > 0.0) {
+        double k0s, k1s, i0s, i1s;
+        BesselFunctions::scaledKI(v, k0s, k1s, i0s, i1s);
+        k0 = k0s * std::exp(-v);
+    }
+    return DualNumber<double, N>::compose(u, BesselFunctions::integralK0(v), k0);
+}
+
+// G(u) e^-u (G = ∫_0^u I0)，导数为 I0(u) e^-u - G(u) e^-u
+double scaledIntegralI0(double u)
+{
+    return BesselFunctions::scaledIntegralI0(u);
+}
+
+template<int N>
+DualNumber<double, N> scaledIntegralI0(const DualNumber<double, N>& u)
+{
+    double v = u.value();
+    double g = BesselFunctions::scaledIntegralI0(v);
+    double k0s, k1s, i0s = 1.0, i1s;
+    if (v > 0.0) BesselFunctions::scaledKI(v, k0s, k1s, i0s, i1s);
+    return DualNumber<double, N>::compose(u, g, i0s - g);
+}
+}
+
+CompositeModelSolver::CompositeModelSolver(ModelType type)
+    : m_type(type), m_responseCache(new ReservoirResponseCache)
+{
+}
+
+bool CompositeModelSolver::hasWellboreStorage(ModelType type)
+{
+    return (type == Model_1 || type == Model_3 || type == Model_5);
+}
+
+bool CompositeModelSolver::hasOuterBoundary(ModelType type)
+{
+    return (type == Model_3 || type == Model_4 || type == Model_5 || type == Model_6);
+}
+
+QVector<double> CompositeModelSolver::generateLogTimeSteps(int count, double startExp, double endExp)
+{
+    QVector<double> t;
+    t.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        double exponent = startExp + (endExp - startExp) * i / (count - 1);
+        t.append(pow(10.0, exponent));
+    }
+    return t;
+}
+
+ModelCurveData CompositeModelSolver::calculateTheoreticalCurve(const ModelParams& params,
+                                                               const QVector<double>& providedTime,
+                                                               const SolverOptions& options,
+                                                               InversionStats* stats) const
+{
+    QVector<double> tPoints = providedTime;
+    if (tPoints.isEmpty()) {
+        tPoints = generateLogTimeSteps(100, -3.0, 3.0);
+    }
+    if (options.coarseGrid.appliesTo(tPoints.size())) {
+        return calculateOnCoarseGrid(params, tPoints, options, stats);
+    }
+    return calculateTheoreticalCurve(params, InversionPlan(tPoints, options.inversionMethod, options.inversionOrder,
+                                                           options.quadratureTolerance), stats,
+                                     options.parallel);
+}
+
+ModelCurveData CompositeModelSolver::calculateTheoreticalCurve(const ModelParams& params, const InversionPlan& plan,
+                                                               InversionStats* stats, const ParallelOptions& parallel) const
+{
+    const QVector<double>& tPoints = plan.time();
+
+    QVector<double> PD_vec, Deriv_vec;
+    calculatePDandDeriv(plan, timeScale(params), params, PD_vec, Deriv_vec, stats, parallel);
+
+    double factor = pressureScale(params);
+    QVector<double> finalP(tPoints.size()), finalDP(tPoints.size());
+
+    for(int i=0; i<tPoints.size(); ++i) {
+        finalP[i] = factor * PD_vec[i];
+        finalDP[i] = factor * Deriv_vec[i];
+    }
+
+    return std::make_tuple(tPoints, finalP, finalDP);
+}
+
+CompositeModelSolver::CurveSensitivity CompositeModelSolver::calculateSensitivity(const ModelParams& params, const InversionPlan& plan,
+                                                                                  const QVector<Sensitivity>& directions,
+                                                                                  InversionStats* stats, const ParallelOptions& parallel) const
+{
+    CurveSensitivity result;
+    result.directions = directions;
+
+    QVector<double> PD_vec, Deriv_vec;
+    QVector<QVector<double>> PDSens, DerivSens;
+    double scale = timeScale(params);
+    switch (m_type) {
+    case Model_1:
+        calculateSensitivityImpl<InfiniteBoundary, true>(plan, scale, params, directions, PD_vec, Deriv_vec, PDSens, DerivSens, stats, parallel); break;
+    case Model_2:
+        calculateSensitivityImpl<InfiniteBoundary, false>(plan, scale, params, directions, PD_vec, Deriv_vec, PDSens, DerivSens, stats, parallel); break;
+    case Model_3:
+        calculateSensitivityImpl<ClosedBoundary, true>(plan, scale, params, directions, PD_vec, Deriv_vec, PDSens, DerivSens, stats, parallel); break;
+    case Model_4:
+        calculateSensitivityImpl<ClosedBoundary, false>(plan, scale, params, directions, PD_vec, Deriv_vec, PDSens, DerivSens, stats, parallel); break;
+    case Model_5:
+        calculateSensitivityImpl<ConstantPressureBoundary, true>(plan, scale, params, directions, PD_vec, Deriv_vec, PDSens, DerivSens, stats, parallel); break;
+    case Model_6:
+        calculateSensitivityImpl<ConstantPressureBoundary, false>(plan, scale, params, directions, PD_vec, Deriv_vec, PDSens, DerivSens, stats, parallel); break;
+    }
+
+    // 偏导数在 pressureScale 固定时与无因次量成同一比例
+    double factor = pressureScale(params);
+    for (int k = 0; k < PD_vec.size(); ++k) {
+        PD_vec[k] *= factor;
+        Deriv_vec[k] *= factor;
+    }
+    for (int i = 0; i < directions.size(); ++i) {
+        for (int k = 0; k < PDSens[i].size(); ++k) {
+            PDSens[i][k] *= factor;
+            DerivSens[i][k] *= factor;
+        }
+    }
+    result.curve = std::make_tuple(plan.time(), PD_vec, Deriv_vec);
+    result.pressure = PDSens;
+    result.derivative = DerivSens;
+    return result;
+}
+
+double CompositeModelSolver::timeScale(const ModelParams& params)
+{
+    double phi = params[ModelParams::Phi];
+    double mu = params[ModelParams::Mu];
+    double Ct = params[ModelParams::Ct];
+    double kf = params[ModelParams::Kf];
+    double L = params[ModelParams::L];
+    return 14.4 * kf / (phi * mu * Ct * pow(L, 2));
+}
+
+double CompositeModelSolver::pressureScale(const ModelParams& params)
+{
+    double mu = params[ModelParams::Mu];
+    double B = params[ModelParams::B];
+    double q = params[ModelParams::Q];
+    double h = params[ModelParams::H];
+    double kf = params[ModelParams::Kf];
+    return 1.842e-3 * q * mu * B / (kf * h);
+}
+
+bool CompositeModelSolver::scalingExponents(ModelParams::Id id, int& timeExponent, int& pressureExponent)
+{
+    switch (id) {
+    case ModelParams::Phi: timeExponent = -1; pressureExponent = 0; return true;
+    case ModelParams::Ct:  timeExponent = -1; pressureExponent = 0; return true;
+    case ModelParams::Mu:  timeExponent = -1; pressureExponent = 1; return true;
+    case ModelParams::H:   timeExponent = 0;  pressureExponent = -1; return true;
+    case ModelParams::Q:   timeExponent = 0;  pressureExponent = 1; return true;
+    case ModelParams::B:   timeExponent = 0;  pressureExponent = 1; return true;
+    default: return false;
+    }
+}
+
+ModelCurveData CompositeModelSolver::calculateOnCoarseGrid(const ModelParams& params, const QVector<double>& time,
+                                                           const SolverOptions& options, InversionStats* stats) const
+{
+    const CoarseGridOptions& grid = options.coarseGrid;
+    double tMin = 0.0, tMax = 0.0;
+    for (double t : time) {
+        if (t <= 0.0) continue;
+        if (tMin == 0.0 || t < tMin) tMin = t;
+        tMax = std::max(tMax, t);
+    }
+    // 时间跨度过小时插值没有意义，直接逐点计算
+    if (tMin <= 0.0 || tMax <= tMin * 1.0001) {
+        return calculateTheoreticalCurve(params, InversionPlan(time, options.inversionMethod, options.inversionOrder,
+                                                               options.quadratureTolerance), stats,
+                                         options.parallel);
+    }
+
+    // 在一组时间点上计算压力与导数 (导数由拉氏空间直接反演，节点上是精确值)
+    auto evaluate = [&](const QVector<double>& t, QVector<double>& p, QVector<double>& d) {
+        InversionPlan plan(t, options.inversionMethod, options.inversionOrder, options.quadratureTolerance);
+        ModelCurveData res = calculateTheoreticalCurve(params, plan, stats, options.parallel);
+        p = std::get<1>(res);
+        d = std::get<2>(res);
+    };
+
+    // 网格上的插值曲线: 数值全为正时在 (ln t, ln y) 空间插值，否则在 (ln t, y) 空间插值；
+    // 压力与导数各自插值，导数不再由压力插值函数求导得到
+    struct LogCurve {
+        MonotoneCubicInterpolator f;
+        bool logY;
+        double value(double x) const { return logY ? std::exp(f.value(x)) : f.value(x); }
+    };
+    auto buildCurve = [](const QVector<double>& lnT, const QVector<double>& v) {
+        bool logY = true;
+        for (double y : v) {
+            if (!(y > 0.0)) { logY = false; break; }
+        }
+        QVector<double> y(v.size());
+        for (int i = 0; i < v.size(); ++i) y[i] = logY ? std::log(v[i]) : v[i];
+        return LogCurve{ MonotoneCubicInterpolator(lnT, y), logY };
+    };
+
+    // 初始对数等距网格
+    double lnMin = std::log(tMin), lnMax = std::log(tMax);
+    int n = std::max(4, int(std::ceil((lnMax - lnMin) / std::log(10.0) * std::max(1, grid.pointsPerDecade))) + 1);
+    QVector<double> nodeX(n), nodeT(n);
+    for (int i = 0; i < n; ++i) {
+        nodeX[i] = lnMin + (lnMax - lnMin) * i / (n - 1);
+        nodeT[i] = std::exp(nodeX[i]);
+    }
+    QVector<double> nodeP, nodeD;
+    evaluate(nodeT, nodeP, nodeD);
+    LogCurve curveP = buildCurve(nodeX, nodeP);
+    LogCurve curveD = buildCurve(nodeX, nodeD);
+
+    // 待检验的区间 (以左端点下标表示)，逐层在中点检验并二分
+    QVector<int> pending(n - 1);
+    for (int i = 0; i < n - 1; ++i) pending[i] = i;
+    double interpolationError = 0.0;
+
+    // 被取消时停止加密 (结果不完整，由调用方丢弃)
+    for (int level = 0; level <= grid.maxRefineLevels && !pending.isEmpty() && !options.parallel.cancellation.isCancelled(); ++level) {
+        QVector<double> midX(pending.size()), midT(pending.size());
+        for (int k = 0; k < pending.size(); ++k) {
+            midX[k] = 0.5 * (nodeX[pending[k]] + nodeX[pending[k] + 1]);
+            midT[k] = std::exp(midX[k]);
+        }
+        QVector<double> midP, midD;
+        evaluate(midT, midP, midD);
+
+        // 合并中点，得到新网格 (pending 按下标递增)
+        QVector<double> mergedX, mergedP, mergedD;
+        QVector<int> midIndex(pending.size());
+        mergedX.reserve(nodeX.size() + pending.size());
+        mergedP.reserve(nodeX.size() + pending.size());
+        mergedD.reserve(nodeX.size() + pending.size());
+        for (int i = 0, k = 0; i < nodeX.size(); ++i) {
+            mergedX.append(nodeX[i]); mergedP.append(nodeP[i]); mergedD.append(nodeD[i]);
+            if (k < pending.size() && pending[k] == i) {
+                midIndex[k] = mergedX.size();
+                mergedX.append(midX[k]); mergedP.append(midP[k]); mergedD.append(midD[k]);
+                ++k;
+            }
+        }
+
+        // 比较旧网格插值与中点处的计算值 (压力与导数)，误差超限的区间其两个子区间进入下一层
+        QVector<int> next;
+        for (int k = 0; k < pending.size(); ++k) {
+            double p = midP[k], d = midD[k];
+            double err = (std::abs(p) > 1e-300) ? std::abs(curveP.value(midX[k]) - p) / std::abs(p) : 0.0;
+            if (std::abs(d) > 1e-300) err = std::max(err, std::abs(curveD.value(midX[k]) - d) / std::abs(d));
+            if (err > grid.tolerance && level < grid.maxRefineLevels) {
+                next.append(midIndex[k] - 1);
+                next.append(midIndex[k]);
+            } else {
+                interpolationError = std::max(interpolationError, err);
+            }
+        }
+        nodeX = mergedX; nodeP = mergedP; nodeD = mergedD;
+        curveP = buildCurve(nodeX, nodeP);
+        curveD = buildCurve(nodeX, nodeD);
+        pending = next;
+    }
+
+    // 映射回观测时间，非正时间保持为 0 (与逐点计算一致)
+    QVector<double> finalP(time.size(), 0.0), finalDP(time.size(), 0.0);
+    for (int i = 0; i < time.size(); ++i) {
+        if (time[i] <= 0.0) continue;
+        double x = std::log(time[i]);
+        finalP[i] = curveP.value(x);
+        finalDP[i] = curveD.value(x);
+    }
+    if (stats) stats->interpolationError = std::max(stats->interpolationError, interpolationError);
+    return std::make_tuple(time, finalP, finalDP);
+}
+
+void CompositeModelSolver::calculatePDandDeriv(const InversionPlan& plan, double timeScale, const ModelParams& params,
+                                               QVector<double>& outPD, QVector<double>& outDeriv, InversionStats* stats,
+                                               const ParallelOptions& parallel) const
+{
+    // 每条曲线按模型类型分派一次，反演循环内调用的是编译期特化的拉氏空间解
+    switch (m_type) {
+    case Model_1:
+        calculatePDandDerivImpl<InfiniteBoundary, true>(plan, timeScale, params, outPD, outDeriv, stats, parallel, m_type, m_responseCache.data()); break;
+    case Model_2:
+        calculatePDandDerivImpl<InfiniteBoundary, false>(plan, timeScale, params, outPD, outDeriv, stats, parallel, m_type, m_responseCache.data()); break;
+    case Model_3:
+        calculatePDandDerivImpl<ClosedBoundary, true>(plan, timeScale, params, outPD, outDeriv, stats, parallel, m_type, m_responseCache.data()); break;
+    case Model_4:
+        calculatePDandDerivImpl<ClosedBoundary, false>(plan, timeScale, params, outPD, outDeriv, stats, parallel, m_type, m_responseCache.data()); break;
+    case Model_5:
+        calculatePDandDerivImpl<ConstantPressureBoundary, true>(plan, timeScale, params, outPD, outDeriv, stats, parallel, m_type, m_responseCache.data()); break;
+    case Model_6:
+        calculatePDandDerivImpl<ConstantPressureBoundary, false>(plan, timeScale, params, outPD, outDeriv, stats, parallel, m_type, m_responseCache.data()); break;
+    }
+}
+
+template<CompositeModelSolver::BoundaryType Boundary, bool Storage>
+void CompositeModelSolver::calculatePDandDerivImpl(const InversionPlan& plan, double timeScale, const ModelParams& params,
+                                                   QVector<double>& outPD, QVector<double>& outDeriv, InversionStats* stats,
+                                                   const ParallelOptions& parallel, int modelType,
+                                                   ReservoirResponseCache* responseCache)
+{
+    int numPoints = plan.pointCount();
+    int groupCount = plan.groupCount();
+    outPD.fill(0.0, numPoints);
+    outDeriv.fill(0.0, numPoints);
+
+    // 节点常数与合成系数由反演方法预先算好，第 g 组的拉氏变量 z = u_j / (timeScale * tRef_g)
+    const LaplaceInversion& inversion = plan.inversion();
+    const QVector<Complex>& unitNodes = inversion.unitNodes();
+    int nodeCount = unitNodes.size();
+
+    QVector<double> tD(numPoints);
+    for (int k = 0; k < numPoints; ++k) tD[k] = timeScale * plan.time()[k];
+
+    // 获取压敏系数 (MATLAB: gamaD)
+    double gamaD = params[ModelParams::GamaD];
+    // 拉氏空间参数与裂缝位置在所有节点间共享，只准备一次
+    LaplaceParams lp = prepareLaplaceParams(params, plan.quadratureTolerance());
+    lp.cancellation = &parallel.cancellation;
+
+    // 储层响应 p̄wD(z) 只取决于储层参数与节点位置，不含 cD、S、gamaD；命中缓存时跳过贝塞尔函数计算
+    QByteArray responseKey;
+    QVector<Complex> response;
+    bool responseCached = false;
+    if (responseCache) {
+        QVector<double> reservoirValues;
+        reservoirValues << lp.M12 << lp.LfD << lp.rmD << lp.reD << lp.omega1 << lp.omega2 << lp.lambda1 << double(lp.nf);
+        responseKey = ReservoirResponseCache::makeKey(modelType, plan, timeScale, reservoirValues);
+        responseCached = responseCache->find(responseKey, response);
+    }
+    if (!responseCached) response.fill(Complex(0.0), groupCount * nodeCount);
+    // 并行块只按各自的组号写入，事先取得数据指针，避免隐式共享的分离发生在多个线程中
+    const Complex* cachedValues = response.constData();
+    Complex* responseValues = responseCached ? nullptr : response.data();
+
+    // 各点的估计相对误差、各组是否参与计算，均按下标写入，归并时按固定顺序进行
+    QVector<double> pointRelError(numPoints, 0.0);
+    QVector<char> groupEvaluated(groupCount, 0);
+
+    // 计算 [first, second) 范围内的节点组；不同块之间只写各自的下标，无需加锁
+    auto evaluateGroups = [&](const QPair<int, int>& range) {
+        QVector<Complex> F(nodeCount), zF(nodeCount);
+        for (int g = range.first; g < range.second; ++g) {
+            // 组内时间都不超过参考时间，参考时间过小时整组保持为 0
+            double tRefD = timeScale * plan.groupReferenceTime(g);
+            if (tRefD <= 1e-12) continue;
+
+            for (int j = 0; j < nodeCount; ++j) {
+                // 被取消时放弃其余节点，未计算的点保持为 0
+                if (parallel.cancellation.isCancelled()) return;
+                int slot = g * nodeCount + j;
+                Complex pf;
+                if (inversion.hasRealNodes()) {
+                    double z = unitNodes[j].real() / tRefD;
+                    double pwd = responseCached ? cachedValues[slot].real() : reservoirResponse<Boundary, double>(z, lp);
+                    if (!responseCached) responseValues[slot] = pwd;
+                    pf = applyWellbore<Storage, double>(z, pwd, lp);
+                } else {
+                    Complex z = unitNodes[j] / tRefD;
+                    Complex pwd = responseCached ? cachedValues[slot] : reservoirResponse<Boundary, Complex>(z, lp);
+                    if (!responseCached) responseValues[slot] = pwd;
+                    pf = applyWellbore<Storage, Complex>(z, pwd, lp);
+                }
+                if (!std::isfinite(pf.real()) || !std::isfinite(pf.imag())) pf = 0.0;
+                F[j] = pf;
+                // dpD/dtD 的拉氏变换为 z*p(z) - pD(0)，pD(0) = 0，复用同一组节点值
+                zF[j] = (unitNodes[j] / tRefD) * pf;
+            }
+            if (!responseCached) groupEvaluated[g] = 1;
+
+            for (int i = plan.groupBegin(g); i < plan.groupEnd(g); ++i) {
+                int k = plan.groupPoint(i);
+                if (tD[k] <= 1e-12) continue;
+                double err = 0.0;
+                double pd = inversion.invert(tD[k], tRefD, F.constData(), &err);
+                if (std::abs(pd) > 1e-300) pointRelError[k] = err / std::abs(pd);
+                // 压力导数 tD * dpD/dtD (即 dpD/dln tD)
+                double dd = tD[k] * inversion.invert(tD[k], tRefD, zF.constData(), nullptr);
+
+                // 摄动法考虑压敏效应 (对应 MATLAB: -1/gamaD * log(1-gamaD*PD))
+                // 导数按链式法则: d/dln t [-1/gamaD * log(1-gamaD*PD)] = (dPD/dln t) / (1-gamaD*PD)
+                if (std::abs(gamaD) > 1e-9) {
+                    double arg = 1.0 - gamaD * pd;
+                    if (arg > 1e-12) {
+                        pd = -1.0 / gamaD * std::log(arg);
+                        dd /= arg;
+                    }
+                }
+                outPD[k] = pd;
+                outDeriv[k] = std::isfinite(dd) ? dd : 0.0;
+            }
+        }
+    };
+
+    // 按节点组分块: 逐点分组的方法 (Stehfest/Euler/Talbot) 每组即一个时间点，de Hoog 每组为一个对数周期
+    QThreadPool* pool = parallel.threadPool ? parallel.threadPool : QThreadPool::globalInstance();
+    int threadCount = parallel.enabled ? std::max(1, pool->maxThreadCount()) : 1;
+    int chunkSize = parallel.chunkSize;
+    if (chunkSize <= 0) {
+        // 自动分块: 每个线程约 4 块，兼顾负载均衡与任务调度开销
+        chunkSize = std::max(1, (groupCount + 4 * threadCount - 1) / (4 * threadCount));
+    }
+
+    if (threadCount <= 1 || groupCount <= chunkSize) {
+        evaluateGroups(qMakePair(0, groupCount));
+    } else {
+        QVector<QPair<int, int>> chunks;
+        for (int g = 0; g < groupCount; g += chunkSize) {
+            chunks.append(qMakePair(g, std::min(g + chunkSize, groupCount)));
+        }
+        // 阻塞式映射: 调用线程也参与执行，线程池已满 (如在拟合线程中调用) 时退化为串行
+        QtConcurrent::blockingMap(pool, chunks, evaluateGroups);
+    }
+
+    if (responseCache && !responseCached && !parallel.cancellation.isCancelled()) responseCache->insert(responseKey, response);
+
+    if (stats) {
+        // 命中储层响应缓存的组不计入拉氏空间求值次数
+        int evaluations = 0;
+        for (int g = 0; g < groupCount; ++g) {
+            if (groupEvaluated[g]) evaluations += nodeCount;
+        }
+        double maxRelError = 0.0;
+        for (int k = 0; k < numPoints; ++k) maxRelError = std::max(maxRelError, pointRelError[k]);
+        stats->laplaceEvaluations += evaluations;
+        stats->maxRelativeError = std::max(stats->maxRelativeError, maxRelError);
+    }
+}
+
+template<CompositeModelSolver::BoundaryType Boundary, bool Storage>
+void CompositeModelSolver::calculateSensitivityImpl(const InversionPlan& plan, double timeScale, const ModelParams& params,
+                                                    const QVector<Sensitivity>& directions,
+                                                    QVector<double>& outPD, QVector<double>& outDeriv,
+                                                    QVector<QVector<double>>& outPDSens, QVector<QVector<double>>& outDerivSens,
+                                                    InversionStats* stats, const ParallelOptions& parallel)
+{
+    int numPoints = plan.pointCount();
+    int groupCount = plan.groupCount();
+    int directionCount = directions.size();
+    outPD.fill(0.0, numPoints);
+    outDeriv.fill(0.0, numPoints);
+    outPDSens = QVector<QVector<double>>(directionCount, QVector<double>(numPoints, 0.0));
+    outDerivSens = QVector<QVector<double>>(directionCount, QVector<double>(numPoints, 0.0));
+
+    const LaplaceInversion& inversion = plan.inversion();
+    const QVector<Complex>& unitNodes = inversion.unitNodes();
+    int nodeCount = unitNodes.size();
+
+    QVector<double> tD(numPoints);
+    for (int k = 0; k < numPoints; ++k) tD[k] = timeScale * plan.time()[k];
+
+    double gamaD = params[ModelParams::GamaD];
+    LaplaceParams lp = prepareLaplaceParams(params, plan.quadratureTolerance());
+    lp.cancellation = &parallel.cancellation;
+
+    // 拉氏空间方向按首次出现的顺序编号为对偶数的导数序号；gamaD 只出现在反演之后的压敏变换中
+    QVector<int> derivativeIndex(directionCount, -1);
+    for (int i = 0; i < directionCount; ++i) {
+        Sensitivity s = directions[i];
+        if (s < 0 || s >= LaplaceSensitivityCount) continue;
+        if (lp.slot[s] < 0) lp.slot[s] = lp.directionCount++;
+        derivativeIndex[i] = lp.slot[s];
+    }
+    const int laplaceCount = lp.directionCount;
+
+    // 并行块只按下标写入，事先取得各输出数组的数据指针
+    QVector<double*> pdSens(directionCount), derivSens(directionCount);
+    for (int i = 0; i < directionCount; ++i) {
+        pdSens[i] = outPDSens[i].data();
+        derivSens[i] = outDerivSens[i].data();
+    }
+    double* pdValues = outPD.data();
+    double* derivValues = outDeriv.data();
+    QVector<double> pointRelError(numPoints, 0.0);
+    QVector<char> groupEvaluated(groupCount, 0);
+
+    auto evaluateGroups = [&](const QPair<int, int>& range) {
+        // 第 s 段 (s = 0 为数值，s >= 1 为第 s-1 个方向的导数) 存放该段在全部节点上的像函数
+        QVector<Complex> F((laplaceCount + 1) * nodeCount), zF((laplaceCount + 1) * nodeCount);
+        QVarLengthArray<double, LaplaceSensitivityCount> dpd(laplaceCount), ddd(laplaceCount);
+        for (int g = range.first; g < range.second; ++g) {
+            double tRefD = timeScale * plan.groupReferenceTime(g);
+            if (tRefD <= 1e-12) continue;
+
+            for (int j = 0; j < nodeCount; ++j) {
+                if (parallel.cancellation.isCancelled()) return;
+                Complex z = unitNodes[j] / tRefD;
+                Complex value;
+                QVarLengthArray<Complex, LaplaceSensitivityCount> derivative(laplaceCount);
+                if (inversion.hasRealNodes()) {
+                    DualReal zr(z.real());
+                    DualReal pf = applyWellbore<Storage, DualReal>(zr, reservoirResponse<Boundary, DualReal>(zr, lp), lp);
+                    value = pf.value();
+                    for (int s = 0; s < laplaceCount; ++s) derivative[s] = pf.derivative(s);
+                } else {
+                    DualComplex zc(z);
+                    DualComplex pf = applyWellbore<Storage, DualComplex>(zc, reservoirResponse<Boundary, DualComplex>(zc, lp), lp);
+                    value = pf.value();
+                    for (int s = 0; s < laplaceCount; ++s) derivative[s] = pf.derivative(s);
+                }
+                if (!std::isfinite(value.real()) || !std::isfinite(value.imag())) value = 0.0;
+                F[j] = value;
+                zF[j] = z * value;
+                for (int s = 0; s < laplaceCount; ++s) {
+                    Complex dv = derivative[s];
+                    if (value == 0.0 || !std::isfinite(dv.real()) || !std::isfinite(dv.imag())) dv = 0.0;
+                    F[(s + 1) * nodeCount + j] = dv;
+                    zF[(s + 1) * nodeCount + j] = z * dv;
+                }
+            }
+            groupEvaluated[g] = 1;
+
+            for (int i = plan.groupBegin(g); i < plan.groupEnd(g); ++i) {
+                int k = plan.groupPoint(i);
+                if (tD[k] <= 1e-12) continue;
+                double err = 0.0;
+                double pd = inversion.invert(tD[k], tRefD, F.constData(), &err);
+                if (std::abs(pd) > 1e-300) pointRelError[k] = err / std::abs(pd);
+                double dd = tD[k] * inversion.invert(tD[k], tRefD, zF.constData(), nullptr);
+                // 反演是线性运算，导数像的反演即反演结果的偏导数
+                for (int s = 0; s < laplaceCount; ++s) {
+                    dpd[s] = inversion.invert(tD[k], tRefD, F.constData() + (s + 1) * nodeCount, nullptr);
+                    ddd[s] = tD[k] * inversion.invert(tD[k], tRefD, zF.constData() + (s + 1) * nodeCount, nullptr);
+                }
+
+                // 压敏变换 p = -ln(arg)/gamaD, d = dd/arg (arg = 1 - gamaD*pd) 的链式法则:
+                // ∂p = ∂pd/arg, ∂d = ∂dd/arg + dd*gamaD*∂pd/arg^2
+                // ∂p/∂gamaD = (gamaD*pd/arg + ln arg)/gamaD^2, ∂d/∂gamaD = dd*pd/arg^2；gamaD -> 0 时分别为 pd^2/2 与 dd*pd
+                double gamaP = 0.0, gamaDeriv = 0.0;
+                if (std::abs(gamaD) > 1e-9) {
+                    double arg = 1.0 - gamaD * pd;
+                    if (arg > 1e-12) {
+                        double lnArg = std::log(arg);
+                        gamaP = (gamaD * pd / arg + lnArg) / (gamaD * gamaD);
+                        gamaDeriv = dd * pd / (arg * arg);
+                        for (int s = 0; s < laplaceCount; ++s) {
+                            ddd[s] = ddd[s] / arg + dd * gamaD * dpd[s] / (arg * arg);
+                            dpd[s] /= arg;
+                        }
+                        pd = -lnArg / gamaD;
+                        dd /= arg;
+                    }
+                } else {
+                    gamaP = 0.5 * pd * pd;
+                    gamaDeriv = dd * pd;
+                }
+                pdValues[k] = pd;
+                derivValues[k] = std::isfinite(dd) ? dd : 0.0;
+                for (int d = 0; d < directionCount; ++d) {
+                    double sp = 0.0, sd = 0.0;
+                    if (derivativeIndex[d] >= 0) {
+                        sp = dpd[derivativeIndex[d]];
+                        sd = ddd[derivativeIndex[d]];
+                    } else if (directions[d] == SensGamaD) {
+                        sp = gamaP;
+                        sd = gamaDeriv;
+                    }
+                    pdSens[d][k] = std::isfinite(sp) ? sp : 0.0;
+                    derivSens[d][k] = std::isfinite(sd) ? sd : 0.0;
+                }
+            }
+        }
+    };
+
+    QThreadPool* pool = parallel.threadPool ? parallel.threadPool : QThreadPool::globalInstance();
+    int threadCount = parallel.enabled ? std::max(1, pool->maxThreadCount()) : 1;
+    int chunkSize = parallel.chunkSize;
+    if (chunkSize <= 0) {
+        chunkSize = std::max(1, (groupCount + 4 * threadCount - 1) / (4 * threadCount));
+    }
+
+    if (threadCount <= 1 || groupCount <= chunkSize) {
+        evaluateGroups(qMakePair(0, groupCount));
+    } else {
+        QVector<QPair<int, int>> chunks;
+        for (int g = 0; g < groupCount; g += chunkSize) {
+            chunks.append(qMakePair(g, std::min(g + chunkSize, groupCount)));
+        }
+        QtConcurrent::blockingMap(pool, chunks, evaluateGroups);
+    }
+
+    if (stats) {
+        // 每个节点的对偶数求值计为一次拉氏空间求值
+        int evaluations = 0;
+        for (int g = 0; g < groupCount; ++g) {
+            if (groupEvaluated[g]) evaluations += nodeCount;
+        }
+        double maxRelError = 0.0;
+        for (int k = 0; k < numPoints; ++k) maxRelError = std::max(maxRelError, pointRelError[k]);
+        stats->laplaceEvaluations += evaluations;
+        stats->maxRelativeError = std::max(stats->maxRelativeError, maxRelError);
+    }
+}
+
+CompositeModelSolver::LaplaceParams CompositeModelSolver::prepareLaplaceParams(const ModelParams& p, double quadratureTolerance)
+{
+    LaplaceParams lp;
+    lp.M12 = p[ModelParams::Kf] / p[ModelParams::Km];
+    lp.LfD = p[ModelParams::LfD];
+    lp.rmD = p[ModelParams::RmD];
+    lp.reD = p[ModelParams::ReD]; // 默认0表示无限大(如果未设置)
+    lp.omega1 = p[ModelParams::Omega1];
+    lp.omega2 = p[ModelParams::Omega2];
+    lp.lambda1 = p[ModelParams::Lambda1];
+    lp.cD = p[ModelParams::CD];
+    lp.S = p[ModelParams::S];
+    lp.nf = (int)p[ModelParams::Nf]; if (lp.nf < 1) lp.nf = 1;
+    if (lp.nf == 1) { lp.xwD.append(0.0); } else {
+        double start = -0.9; double end = 0.9; double step = (end - start) / (lp.nf - 1);
+        for (int i = 0; i < lp.nf; ++i) lp.xwD.append(start + i * step);
+    }
+    lp.ywD.fill(0.0, lp.nf);
+    lp.uniformGrid = isUniformFractureGrid(lp.xwD, lp.ywD);
+    for (int s = 0; s < LaplaceSensitivityCount; ++s) lp.slot[s] = -1;
+    lp.directionCount = 0;
+    lp.quadratureTolerance = quadratureTolerance;
+    lp.cancellation = nullptr;
+    return lp;
+}
+
+template<typename P>
+P CompositeModelSolver::laplaceParam(const LaplaceParams& lp, Sensitivity s, double value)
+{
+    return DualTraits<P>::seed(value, lp.slot[s], lp.directionCount);
+}
+
+template<CompositeModelSolver::BoundaryType Boundary, typename T>
+T CompositeModelSolver::reservoirResponse(const T& z, const LaplaceParams& lp)
+{
+    typedef typename ParamType<T>::Type P;
+    const P omega1 = laplaceParam<P>(lp, SensOmega1, lp.omega1);
+    const P omega2 = laplaceParam<P>(lp, SensOmega2, lp.omega2);
+    const P lambda1 = laplaceParam<P>(lp, SensLambda1, lp.lambda1);
+    const P M12 = laplaceParam<P>(lp, SensM12, lp.M12);
+    T fs1 = omega1 + lambda1 * omega2 / (lambda1 + z * omega2);
+    T fs2 = T(M12 * omega2);
+
+    // 调用通用 PWD 计算内核，边界条件在编译期确定
+    return PWD_composite<Boundary, T>(z, fs1, fs2, lp);
+}
+
+template<bool Storage, typename T>
+T CompositeModelSolver::applyWellbore(const T& z, const T& pwd, const LaplaceParams& lp)
+{
+    // 考虑井筒储存和表皮 (对应 MATLAB: (z*pf+S)/(z+CD*z^2*(z*pf+S)))
+    // 仅对变井储模型 (1, 3, 5) 启用
+    if constexpr (Storage) {
+        if (lp.cD > 1e-12 || std::abs(lp.S) > 1e-12) {
+            typedef typename ParamType<T>::Type P;
+            const P CD = laplaceParam<P>(lp, SensCD, lp.cD);
+            const P S = laplaceParam<P>(lp, SensS, lp.S);
+            return (z * pwd + S) / (z + CD * z * z * (z * pwd + S));
+        }
+    } else {
+        (void)z; (void)lp;
+    }
+    return pwd;
+}
+
+template<CompositeModelSolver::BoundaryType Boundary, typename T>
+T CompositeModelSolver::PWD_composite(const T& z, const T& fs1, const T& fs2, const LaplaceParams& lp)
+{
+    using std::sqrt;
+    using std::exp;
+    using std::abs;
+    typedef typename ParamType<T>::Type P;
+    const P M12 = laplaceParam<P>(lp, SensM12, lp.M12);
+    const P LfD = laplaceParam<P>(lp, SensLfD, lp.LfD);
+    const P rmD = laplaceParam<P>(lp, SensRmD, lp.rmD);
+    const P reD = laplaceParam<P>(lp, SensReD, lp.reD);
+    const int nf = lp.nf;
+    const QVector<double>& xwD = lp.xwD;
+    const QVector<double>& ywD = lp.ywD;
+    T gama1 = sqrt(z * fs1);
+    T gama2 = sqrt(z * fs2);
+    T arg_g2_rm = gama2 * rmD;
+    T arg_g1_rm = gama1 * rmD;
+
+    // 使用缩放贝塞尔函数以避免数值溢出
+    T k0_g2, k1_g2, i0_g2_s, i1_g2_s;
+    T k0_g1, k1_g1, i0_g1_s, i1_g1_s;
+    besselKI(arg_g2_rm, k0_g2, k1_g2, i0_g2_s, i1_g2_s);
+    besselKI(arg_g1_rm, k0_g1, k1_g1, i0_g1_s, i1_g1_s);
+
+    // --- 边界条件因子计算 mAB ---
+    // MATLAB 对应关系:
+    // Infinite: mAB = 0
+    // Closed:   mAB = K1(re)/I1(re)
+    // ConstP:   mAB = -K0(re)/I0(re)
+
+    T term_mAB_i0 = 0.0;
+    T term_mAB_i1 = 0.0;
+
+    if constexpr (Boundary != InfiniteBoundary) {
+        T arg_re = gama2 * reD;
+        T k0_re, k1_re, i0_re_s, i1_re_s;
+        besselKI(arg_re, k0_re, k1_re, i0_re_s, i1_re_s);
+
+        if constexpr (Boundary == ClosedBoundary) {
+            // 封闭边界: ratio based on K1/I1
+            if (abs(i1_re_s) > 1e-100) {
+                // 计算 mAB * I0(g2*rmD) 和 mAB * I1(g2*rmD)
+                // 引入 exp(arg_g2_rm - arg_re) 来处理指数项的缩放
+                term_mAB_i0 = (k1_re / i1_re_s) * i0_g2_s * exp(arg_g2_rm - arg_re);
+                term_mAB_i1 = (k1_re / i1_re_s) * i1_g2_s * exp(arg_g2_rm - arg_re);
+            }
+        } else {
+            // 定压边界: ratio based on -K0/I0
+            if (abs(i0_re_s) > 1e-100) {
+                term_mAB_i0 = -(k0_re / i0_re_s) * i0_g2_s * exp(arg_g2_rm - arg_re);
+                term_mAB_i1 = -(k0_re / i0_re_s) * i1_g2_s * exp(arg_g2_rm - arg_re);
+            }
+        }
+    }
+
+    // MATLAB: Acup = M12*gama1*K1(g1)*(mAB*I0(g2)+K0(g2)) + gama2*K0(g1)*(mAB*I1(g2)-K1(g2))
+    T term1 = term_mAB_i0 + k0_g2; // (mAB*I0 + K0)
+    T term2 = term_mAB_i1 - k1_g2; // (mAB*I1 - K1)
+
+    T Acup = M12 * gama1 * k1_g1 * term1 + gama2 * k0_g1 * term2;
+
+    // MATLAB: Acdown = M12*gama1*I1(g1)*(...) - gama2*I0(g1)*(...)
+    // 我们这里计算 scaled 版本 Acdown * exp(-arg_g1_rm)
+    T Acdown_scaled = M12 * gama1 * i1_g1_s * term1 - gama2 * i0_g1_s * term2;
+
+    if (abs(Acdown_scaled) < 1e-100) Acdown_scaled = 1e-100;
+
+    // Ac = Acup / Acdown
+    // Ac_prefactor = Acup / Acdown_scaled = Ac * exp(arg_g1_rm)
+    T Ac_prefactor = Acup / Acdown_scaled;
+
+    // 裂缝 i 对裂缝 j 的影响系数: 对积分核 K0 + Ac*I0 沿裂缝半长积分
+    // 只与两条裂缝的相对位置 (dx, dy) 有关
+    auto influence = [&](double dx, double dy) -> T {
+        return influenceCoefficient(gama1, arg_g1_rm, Ac_prefactor, M12, LfD, dx, dy, lp.quadratureTolerance);
+    };
+
+    // --- 等间距裂缝: 影响矩阵为对称 Toeplitz 矩阵 ---
+    // 裂缝位于等间距 xwD 网格且 ywD 全为 0 时，(i,j) 元素只与 i-j 有关;
+    // 又因积分区间 [-LfD, LfD] 对称，令 a -> -a 可知 i-j 与 j-i 的积分相等。
+    // 因此只需计算 nf 个不同的积分 (而非 nf^2 个)，再用 Levinson 递推求解。
+    if (lp.uniformGrid) {
+        double step = (nf > 1) ? (xwD[1] - xwD[0]) : 0.0;
+        QVarLengthArray<T, kMaxStackFractures> column(nf);
+        for (int k = 0; k < nf; ++k) {
+            if (lp.cancellation && lp.cancellation->isCancelled()) return T(0.0);
+            column[k] = influence(k * step, 0.0);
+        }
+
+        // 加边方程组 [T -1; z*1^T 0][q; p] = [0; 1] 的解为:
+        // T*y = 1, p = 1 / (z * sum(y))
+        QVarLengthArray<T, kMaxStackFractures> ones(nf), y(nf);
+        for (int k = 0; k < nf; ++k) ones[k] = T(1.0);
+        if (solveSymmetricToeplitz(column.constData(), ones.constData(), nf, y.data())) {
+            T sumY = 0.0;
+            for (int k = 0; k < nf; ++k) sumY += y[k];
+            if (abs(sumY) > 1e-300) return T(1.0) / (z * sumY);
+        }
+
+        // Levinson 递推中途主元过小 (矩阵非强正则)，退回稠密 LU 求解
+        QVector<T> A(nf * nf);
+        for (int i = 0; i < nf; ++i) {
+            for (int j = 0; j < nf; ++j) A[i * nf + j] = column[std::abs(i - j)];
+        }
+        return solveBorderedSystem(A.constData(), nf, z);
+    }
+
+    // --- 一般布缝: 逐个元素积分 ---
+    QVector<T> A(nf * nf);
+    for (int i = 0; i < nf; ++i) {
+        // 每行 nf 次自适应积分，逐行检查取消
+        if (lp.cancellation && lp.cancellation->isCancelled()) return T(0.0);
+        for (int j = 0; j < nf; ++j) {
+            A[i * nf + j] = influence(xwD[i] - xwD[j], ywD[i] - ywD[j]);
+        }
+    }
+    return solveBorderedSystem(A.constData(), nf, z);
+}
+
+template<typename T>
+T CompositeModelSolver::solveBorderedSystem(const T* influence, int nf, const T& z)
+{
+    // 最后一行为流量条件 z * sum(q) = 1
+    int size = nf + 1;
+    if constexpr (!DualTraits<T>::isDual) {
+        Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> A_mat(size, size);
+        Eigen::Matrix<T, Eigen::Dynamic, 1> b_vec(size);
+        b_vec.setZero(); b_vec(nf) = 1.0;
+        for (int i = 0; i < nf; ++i) {
+            for (int j = 0; j < nf; ++j) A_mat(i, j) = influence[i * nf + j];
+            A_mat(i, nf) = -1.0; A_mat(nf, i) = z;
+        }
+        A_mat(nf, nf) = 0.0;
+        return A_mat.fullPivLu().solve(b_vec)(nf);
+    } else {
+        typedef typename DualTraits<T>::Scalar S;
+        typedef Eigen::Matrix<S, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+        typedef Eigen::Matrix<S, Eigen::Dynamic, 1> Vector;
+        Matrix A_mat(size, size);
+        Vector b_vec(size);
+        b_vec.setZero(); b_vec(nf) = 1.0;
+        int count = z.count();
+        for (int i = 0; i < nf; ++i) {
+            for (int j = 0; j < nf; ++j) {
+                A_mat(i, j) = influence[i * nf + j].value();
+                count = std::max(count, influence[i * nf + j].count());
+            }
+            A_mat(i, nf) = -1.0; A_mat(nf, i) = z.value();
+        }
+        A_mat(nf, nf) = 0.0;
+        Eigen::FullPivLU<Matrix> lu = A_mat.fullPivLu();
+        Vector x = lu.solve(b_vec);
+
+        // 右端项不含参数: M x = b => M x' = -M' x
+        S derivative[LaplaceSensitivityCount];
+        for (int s = 0; s < count; ++s) {
+            Vector rhs(size);
+            for (int i = 0; i < nf; ++i) {
+                S r = 0.0;
+                for (int j = 0; j < nf; ++j) r -= influence[i * nf + j].derivative(s) * x(j);
+                rhs(i) = r;
+            }
+            S zs = z.derivative(s);
+            S r = 0.0;
+            for (int j = 0; j < nf; ++j) r -= zs * x(j);
+            rhs(nf) = r;
+            derivative[s] = lu.solve(rhs)(nf);
+        }
+        return T(x(nf), derivative, count);
+    }
+}
+
+double CompositeModelSolver::influenceCoefficient(double gama1, double arg_g1_rm, double Ac_prefactor, double M12, double LfD,
+                                                  double dx, double dy, double eps)
+{
+    return influenceByTable<double>(gama1, arg_g1_rm, Ac_prefactor, M12, LfD, dx, dy, eps);
+}
+
+CompositeModelSolver::Complex CompositeModelSolver::influenceCoefficient(const Complex& gama1, const Complex& arg_g1_rm, const Complex& Ac_prefactor,
+                                                                         double M12, double LfD, double dx, double dy, double eps)
+{
+    // 复宗量没有累积积分表，沿用自适应积分
+    return influenceByQuadrature<Complex, double>(gama1, arg_g1_rm, Ac_prefactor, M12, LfD, dx, dy, eps);
+}
+
+CompositeModelSolver::DualReal CompositeModelSolver::influenceCoefficient(const DualReal& gama1, const DualReal& arg_g1_rm, const DualReal& Ac_prefactor,
+                                                                          const DualReal& M12, const DualReal& LfD, double dx, double dy,
+                                                                          double eps)
+{
+    return influenceByTable<DualReal>(gama1, arg_g1_rm, Ac_prefactor, M12, LfD, dx, dy, eps);
+}
+
+CompositeModelSolver::DualComplex CompositeModelSolver::influenceCoefficient(const DualComplex& gama1, const DualComplex& arg_g1_rm,
+                                                                             const DualComplex& Ac_prefactor, const DualComplex& M12,
+                                                                             const DualComplex& LfD, double dx, double dy, double eps)
+{
+    return influenceByQuadrature<DualComplex, DualComplex>(gama1, arg_g1_rm, Ac_prefactor, M12, LfD, dx, dy, eps);
+}
+
+template<typename R>
+R CompositeModelSolver::influenceByTable(const R& gama1, const R& arg_g1_rm, const R& Ac_prefactor, const R& M12, const R& LfD,
+                                         double dx, double dy, double eps)
+{
+    using std::exp;
+    using std::abs;
+    // 裂缝不共线时积分核没有奇点，直接数值积分
+    if (dy != 0.0 || LfD <= 0.0 || gama1 <= 0.0) {
+        return influenceByQuadrature<R, R>(gama1, arg_g1_rm, Ac_prefactor, M12, LfD, dx, dy, eps);
+    }
+
+    double d = std::abs(dx);
+    R uPlus = gama1 * (d + LfD);
+    R uMinus = gama1 * (d - LfD); // 源点在裂缝段内时为负
+
+    // K0 部分: ∫_{-LfD}^{LfD} K0(γ|dx-a|) da
+    R termK = 0.0;
+    if (d < 2.0 * LfD) {
+        // 自身与相邻裂缝段: 对数奇点在积分区间内或附近，由累积积分 F(u) = ∫_0^u K0 两次查表得到
+        // 区间跨过奇点时为 [F(u+) + F(|u-|)]/γ，否则为 [F(u+) - F(u-)]/γ
+        if (uMinus < 0.0) termK = integralK0(uPlus) + integralK0(-uMinus);
+        else termK = integralK0(uPlus) - integralK0(uMinus);
+        termK /= gama1;
+    } else {
+        // 远处裂缝段: 积分核光滑，8 点 Gauss-Legendre 定阶积分
+        static const double X[] = { 0.1834346424956498, 0.5255324099163290, 0.7966664774136267, 0.9602898564975363 };
+        static const double W[] = { 0.3626837833783620, 0.3137066458778873, 0.2223810344533745, 0.1012285362903763 };
+        R arg[8], k0s[8], i0s[8];
+        for (int i = 0; i < 4; ++i) {
+            arg[2 * i] = gama1 * (d - LfD * X[i]);
+            arg[2 * i + 1] = gama1 * (d + LfD * X[i]);
+        }
+        scaledBesselK0I0(arg, 8, k0s, i0s);
+        for (int i = 0; i < 4; ++i) {
+            termK += W[i] * (k0s[2 * i] * exp(-arg[2 * i]) + k0s[2 * i + 1] * exp(-arg[2 * i + 1]));
+        }
+        termK *= LfD;
+    }
+
+    // I0 部分 (解析、无奇点): Ac * e^{-γ rmD} * ∫ I0(γ|dx-a|) da = Ac * e^{-γ rmD} [G(u+) - G(u-)]/γ，
+    // G(u) = ∫_0^u I0 为奇函数，用缩放值 G(u) e^-u 避免溢出
+    R termI = 0.0;
+    R exponentPlus = uPlus - arg_g1_rm;
+    if (exponentPlus > -700.0) {
+        R gMinus = scaledIntegralI0(abs(uMinus)) * exp(abs(uMinus) - arg_g1_rm);
+        if (uMinus < 0.0) gMinus = -gMinus;
+        termI = Ac_prefactor * (scaledIntegralI0(uPlus) * exp(exponentPlus) - gMinus) / gama1;
+    }
+
+    return (termK + termI) / (M12 * 2 * LfD);
+}
+
+template<typename T, typename P>
+T CompositeModelSolver::influenceByQuadrature(const T& gama1, const T& arg_g1_rm, const T& Ac_prefactor, const P& M12, const P& LfD,
+                                              double dx, double dy, double eps)
+{
+    using std::exp;
+    using std::abs;
+    using std::real;
+    // 一次求出一个 Gauss 面板上全部节点的积分核 (n <= 15)
+    auto integrand = [&](const double* a, int n, T* out) {
+        T arg_dist[15], k0_dist_s[15], i0_dist_s[15];
+        for (int i = 0; i < n; ++i) {
+            double dist = std::sqrt(std::pow(dx - a[i], 2) + std::pow(dy, 2));
+            arg_dist[i] = gama1 * dist; if (abs(arg_dist[i]) < 1e-10) arg_dist[i] = 1e-10;
+        }
+        scaledBesselK0I0(arg_dist, n, k0_dist_s, i0_dist_s);
+
+        for (int i = 0; i < n; ++i) {
+            // 计算 Ac * I0(g1*dist)
+            // = (Ac_prefactor * exp(-arg_g1_rm)) * (scaled_I0 * exp(arg_dist))
+            // = Ac_prefactor * scaled_I0 * exp(arg_dist - arg_g1_rm)
+            T exponent = arg_dist[i] - arg_g1_rm;
+            T value = k0_dist_s[i] * exp(-arg_dist[i]);
+            if (real(exponent) > -700.0) {
+                value += Ac_prefactor * i0_dist_s[i] * exp(exponent);
+            }
+            out[i] = value;
+        }
+    };
+    double halfLength = real(LfD);
+    T val = adaptiveGauss<T>(integrand, -halfLength, halfLength, eps, 0, 10);
+    if constexpr (DualTraits<P>::isDual) {
+        // 积分限随 LfD 变化: d/dLfD ∫_{-LfD}^{LfD} f = f(LfD) + f(-LfD)
+        double ends[2] = { halfLength, -halfLength };
+        T f[2];
+        integrand(ends, 2, f);
+        val += T::compose(LfD, 0.0, (f[0] + f[1]).value());
+    }
+    return val / (M12 * 2 * LfD);
+}
+
+bool CompositeModelSolver::isUniformFractureGrid(const QVector<double>& xwD, const QVector<double>& ywD)
+{
+    int nf = xwD.size();
+    if (nf == 0 || ywD.size() != nf) return false;
+    for (double y : ywD) {
+        if (y != 0.0) return false;
+    }
+    if (nf <= 2) return true;
+
+    double step = xwD[1] - xwD[0];
+    double tol = 1e-12 * std::max(1.0, std::abs(step));
+    for (int i = 2; i < nf; ++i) {
+        if (std::abs((xwD[i] - xwD[i - 1]) - step) > tol) return false;
+    }
+    return true;
+}
+
+template<typename T>
+bool CompositeModelSolver::solveSymmetricToeplitz(const T* column, const T* rhs, int n, T* x)
+{
+    // Levinson 递推 (Golub & Van Loan, Algorithm 4.7.2)，O(n^2)
+    // column 为 Toeplitz 矩阵第一列 [r0, r1, ..., r(n-1)]
+    // 复数时为复对称 (非 Hermite) 矩阵，递推公式不变
+    if (n <= 0) return false;
+    for (int i = 0; i < n; ++i) x[i] = T(0.0);
+
+    T r0 = column[0];
+    using std::abs;
+    if (abs(r0) < 1e-300) return false;
+
+    // 归一化为单位对角
+    QVarLengthArray<T, kMaxStackFractures> r(n), b(n);
+    for (int i = 0; i < n; ++i) { r[i] = column[i] / r0; b[i] = rhs[i] / r0; }
+
+    x[0] = b[0];
+    if (n == 1) return true;
+
+    QVarLengthArray<T, kMaxStackFractures> y(n), v(n);
+    for (int i = 0; i < n; ++i) { y[i] = T(0.0); v[i] = T(0.0); }
+    y[0] = -r[1];
+    T beta = 1.0;
+    T alpha = -r[1];
+
+    for (int k = 1; k < n; ++k) {
+        beta = (1.0 - alpha * alpha) * beta;
+        if (abs(beta) < 1e-14) return false;
+
+        T s = b[k];
+        for (int i = 0; i < k; ++i) s -= r[i + 1] * x[k - 1 - i];
+        T mu = s / beta;
+        for (int i = 0; i < k; ++i) v[i] = x[i] + mu * y[k - 1 - i];
+        for (int i = 0; i < k; ++i) x[i] = v[i];
+        x[k] = mu;
+
+        if (k < n - 1) {
+            T t = -r[k + 1];
+            for (int i = 0; i < k; ++i) t -= r[i + 1] * y[k - 1 - i];
+            alpha = t / beta;
+            for (int i = 0; i < k; ++i) v[i] = y[i] + alpha * y[k - 1 - i];
+            for (int i = 0; i < k; ++i) y[i] = v[i];
+            y[k] = alpha;
+        }
+    }
+    return true;
+}
+
+template<typename T>
+void CompositeModelSolver::besselKI(const T& x, T& k0, T& k1, T& i0s, T& i1s)
+{
+    using std::exp;
+    T k0s, k1s;
+    scaledBesselKI(x, k0s, k1s, i0s, i1s);
+    T emx = exp(-x);
+    k0 = k0s * emx;
+    k1 = k1s * emx;
+}
+
+template<typename T, typename Func>
+T CompositeModelSolver::gauss15(const Func& f, double a, double b)
+{
+    static const double X[] = { 0.0, 0.201194, 0.394151, 0.570972, 0.724418, 0.848207, 0.937299, 0.987993 };
+    static const double W[] = { 0.202578, 0.198431, 0.186161, 0.166269, 0.139571, 0.107159, 0.070366, 0.030753 };
+    double h = 0.5 * (b - a); double c = 0.5 * (a + b);
+    // 节点顺序: c, c-dx1, c+dx1, c-dx2, ...，整个面板一次求值
+    double nodes[15]; T values[15];
+    nodes[0] = c;
+    for (int i = 1; i < 8; ++i) { double dx = h * X[i]; nodes[2 * i - 1] = c - dx; nodes[2 * i] = c + dx; }
+    f(nodes, 15, values);
+    T s = W[0] * values[0];
+    for (int i = 1; i < 8; ++i) s += W[i] * (values[2 * i - 1] + values[2 * i]);
+    return s * h;
+}
+
+template<typename T, typename Func>
+T CompositeModelSolver::adaptiveGauss(const Func& f, double a, double b, double eps, int depth, int maxDepth)
+{
+    double c = (a + b) / 2.0; T v1 = gauss15<T>(f, a, b); T v2 = gauss15<T>(f, a, c) + gauss15<T>(f, c, b);
+    using std::abs;
+    if (depth >= maxDepth || abs(v1 - v2) < 1e-10 * abs(v2) + eps) return v2;
+    return adaptiveGauss<T>(f, a, c, eps/2, depth+1, maxDepth) + adaptiveGauss<T>(f, c, b, eps/2, depth+1, maxDepth);
+}
+
+// 储层响应的显式实例 (供 tests/tst_compositemodelsolver 在本文件之外调用)
+template double CompositeModelSolver::reservoirResponse<CompositeModelSolver::InfiniteBoundary, double>(const double&, const LaplaceParams&);
+template double CompositeModelSolver::reservoirResponse<CompositeModelSolver::ClosedBoundary, double>(const double&, const LaplaceParams&);
+template double CompositeModelSolver::reservoirResponse<CompositeModelSolver::ConstantPressureBoundary, double>(const double&, const LaplaceParams&);
+template CompositeModelSolver::Complex CompositeModelSolver::reservoirResponse<CompositeModelSolver::InfiniteBoundary, CompositeModelSolver::Complex>(const Complex&, const LaplaceParams&);
+template CompositeModelSolver::Complex CompositeModelSolver::reservoirResponse<CompositeModelSolver::ClosedBoundary, CompositeModelSolver::Complex>(const Complex&, const LaplaceParams&);
+template CompositeModelSolver::Complex CompositeModelSolver::reservoirResponse<CompositeModelSolver::ConstantPressureBoundary, CompositeModelSolver::Complex>(const Complex&, const LaplaceParams&);
@@ -0,0 +1,298 @@
+/*
+ * compositemodelsolver.h
+ * 文件作用：压裂水平井复合页岩油模型 (模型1-6) 的无界面求解器头文件
+ * 功能描述：
+ * 1. 从 ModelWidget01_06 中剥离出的纯计算内核，不依赖任何 QWidget
+ * 2. 所有计算接口均为 const，可在多个线程中同时调用；唯一的可变状态是内部加锁的拉氏空间储层响应缓存
+ * 3. 数值反演方法与阶数通过 SolverOptions 按次传入，不再依赖全局开关
+ * 4. 拉氏空间解对实数/复数拉氏变量均可计算，支持 Stehfest 以外的复平面反演方法
+ * 5. 供 ModelManager、FittingWidget、敏感性分析以及单元测试/基准测试直接调用
+ * 6. 反演计划中的各节点组 (时间点) 互相独立，可按块分配到线程池并行计算，结果与串行计算逐位一致
+ * 7. 参数以定长索引的 ModelParams 传入，与具名参数表的转换由界面与项目文件一侧完成
+ * 8. 拉氏空间解以外边界类型与井储标志为模板参数，六个模型各实例化一次
+ * 9. 可选粗网格模式: 在自适应加密的对数网格上计算，再以双对数保单调三次插值映射到观测时间，
+ *    计算量基本与观测数据的采样密度无关
+ * 10. 拉氏空间解分为储层响应与井储表皮两层，储层响应按节点缓存；只改变 cD、S、gamaD
+ *     (或 h、q、B) 时不再计算贝塞尔函数，只重新施加井储公式与反演求和
+ * 11. 拉氏空间解同时以对偶数 (DualNumber) 实例化，前向自动微分给出理论曲线对各无因次参数的精确偏导数
+ * 12. 协作式取消: 反演循环逐节点、影响矩阵逐行/逐元素轮询 ParallelOptions 中的取消令牌，被取消时尽快返回
+ *     (结果不完整，不写入储层响应缓存)
+ */
+
+#ifndef COMPOSITEMODELSOLVER_H
+#define COMPOSITEMODELSOLVER_H
+
+#include <QMap>
+#include <QVector>
+#include <QString>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <tuple>
+#include <complex>
+#include "laplaceinversion.h"
+#include "modelparams.h"
+#include "dualnumber.h"
+#include "cancellationtoken.h"
+
+class ReservoirResponseCache;
+
+// 类型定义: <时间, 压力, 导数>
+using ModelCurveData = std::tuple<QVector<double>, QVector<double>, QVector<double>>;
+
+class CompositeModelSolver
+{
+public:
+    enum ModelType {
+        Model_1 = 0, // 无限大 + 变井储
+        Model_2,     // 无限大 + 恒定井储
+        Model_3,     // 封闭边界 + 变井储
+        Model_4,     // 封闭边界 + 恒定井储
+        Model_5,     // 定压边界 + 变井储
+        Model_6      // 定压边界 + 恒定井储
+    };
+
+    // 时间点并行选项: 按块把反演计划的节点组分配到线程池，调用线程也参与计算
+    // 在线程池工作线程中调用 (如拟合线程) 时不会死锁: 没有空闲线程时由调用线程独自完成
+    struct ParallelOptions {
+        QThreadPool* threadPool; // 使用的线程池，为空时使用 QThreadPool::globalInstance()
+        int chunkSize;           // 每个任务包含的节点组数 (逐点分组的方法即时间点数)，<= 0 时自动确定
+        bool enabled;            // 为 false 时在调用线程中串行计算
+        CancellationToken cancellation; // 取消令牌 (默认永不取消)；被取消时结果不完整，调用方应丢弃
+
+        ParallelOptions() : threadPool(nullptr), chunkSize(0), enabled(true) {}
+
+        static ParallelOptions serial()
+        {
+            ParallelOptions o;
+            o.enabled = false;
+            return o;
+        }
+    };
+
+    // 粗网格插值选项: 先在每十倍时间 pointsPerDecade 个点的对数网格上计算，
+    // 在区间中点检验插值误差，超过 tolerance 的区间继续二分 (至多 maxRefineLevels 层)
+    struct CoarseGridOptions {
+        bool enabled;
+        int pointsPerDecade;   // 初始网格密度
+        double tolerance;      // 中点处压力/导数插值的相对误差限
+        int maxRefineLevels;   // 最大加密层数
+        int minPoints;         // 时间点少于此数时直接逐点计算
+
+        CoarseGridOptions() : enabled(false), pointsPerDecade(6), tolerance(1e-3), maxRefineLevels(4), minPoints(200) {}
+
+        // 对给定时间点数是否采用粗网格
+        bool appliesTo(int pointCount) const { return enabled && pointCount >= minPoints; }
+    };
+
+    // 单次计算的数值选项 (按调用传入，求解器自身不保存)
+    struct SolverOptions {
+        LaplaceInversion::Method inversionMethod; // 数值反演方法
+        int inversionOrder;                       // 反演阶数 (Stehfest 为 N，其余方法为 M)
+        double quadratureTolerance;               // 裂缝影响系数自适应积分的容差 (复数节点与不共线裂缝)
+        ParallelOptions parallel;                 // 时间点并行选项
+        CoarseGridOptions coarseGrid;             // 粗网格插值选项 (默认关闭)
+
+        SolverOptions() : inversionMethod(LaplaceInversion::Stehfest), inversionOrder(12),
+                          quadratureTolerance(InversionPlan::DefaultQuadratureTolerance) {}
+
+        static SolverOptions highPrecision(LaplaceInversion::Method method = LaplaceInversion::Stehfest)
+        {
+            SolverOptions o;
+            o.inversionMethod = method;
+            o.inversionOrder = LaplaceInversion::defaultOrder(method, true);
+            return o;
+        }
+        static SolverOptions lowPrecision(LaplaceInversion::Method method = LaplaceInversion::Stehfest)
+        {
+            SolverOptions o;
+            o.inversionMethod = method;
+            o.inversionOrder = LaplaceInversion::defaultOrder(method, false);
+            return o;
+        }
+    };
+
+    // 解析偏导数的方向: 拉氏空间解直接依赖的无因次量 (前 LaplaceSensitivityCount 个) 与压敏系数 gamaD
+    // kf、km、L、Lf 等有因次参数经 M12 = kf/km、LfD = Lf/L 以及 timeScale / pressureScale 进入，由调用方按链式法则组合
+    enum Sensitivity {
+        SensM12 = 0,
+        SensLfD,
+        SensRmD,
+        SensReD,
+        SensOmega1,
+        SensOmega2,
+        SensLambda1,
+        SensCD,
+        SensS,
+        SensGamaD,
+        SensitivityCount,
+        LaplaceSensitivityCount = SensGamaD
+    };
+
+    // 理论曲线及其偏导数 (timeScale、pressureScale 固定不变)
+    struct CurveSensitivity {
+        ModelCurveData curve;                // 同一次计算得到的理论曲线，与 calculateTheoreticalCurve 的结果一致
+        QVector<Sensitivity> directions;
+        QVector<QVector<double>> pressure;   // pressure[i][k]: 第 k 点压差对 directions[i] 的偏导数 (MPa)
+        QVector<QVector<double>> derivative; // derivative[i][k]: 第 k 点压力导数对 directions[i] 的偏导数 (MPa)
+    };
+
+    explicit CompositeModelSolver(ModelType type);
+
+    ModelType type() const { return m_type; }
+
+    // 模型特征查询
+    static bool hasWellboreStorage(ModelType type); // 变井储模型 (1, 3, 5)
+    static bool hasOuterBoundary(ModelType type);   // 封闭或定压边界模型 (3, 4, 5, 6)
+
+    // 计算理论曲线: 返回 <时间(h), 压差(MPa), 压力导数(MPa)>
+    // providedTime 为空时使用默认的 1e-3 ~ 1e3 h 对数时间序列
+    // stats 非空时累加拉氏空间求值次数，并更新最大估计相对误差 (粗网格模式下还更新插值误差)
+    ModelCurveData calculateTheoreticalCurve(const ModelParams& params,
+                                             const QVector<double>& providedTime = QVector<double>(),
+                                             const SolverOptions& options = SolverOptions(),
+                                             InversionStats* stats = nullptr) const;
+
+    // 在预先构建的反演计划上计算理论曲线 (时间网格、反演方法与阶数取自 plan)
+    // 同一时间网格需要反复计算时 (如拟合迭代)，由调用方构建一次 plan 后重复使用
+    ModelCurveData calculateTheoreticalCurve(const ModelParams& params, const InversionPlan& plan,
+                                             InversionStats* stats = nullptr,
+                                             const ParallelOptions& parallel = ParallelOptions()) const;
+
+    // 前向自动微分: 拉氏空间解以对偶数 (值 + 各方向导数) 在同一组反演节点上求值，每个方向的导数像再做一次反演求和；
+    // 结果即数值反演曲线的精确偏导数，一次计算代替 2*n 次有限差分扰动。不经过储层响应缓存
+    CurveSensitivity calculateSensitivity(const ModelParams& params, const InversionPlan& plan,
+                                          const QVector<Sensitivity>& directions,
+                                          InversionStats* stats = nullptr,
+                                          const ParallelOptions& parallel = ParallelOptions()) const;
+
+    // 量纲换算: tD = timeScale(params) * t(h)，压差 = pressureScale(params) * pD
+    static double timeScale(const ModelParams& params);
+    static double pressureScale(const ModelParams& params);
+    // 纯缩放参数 (phi, mu, Ct, h, q, B): 只以幂次进入 timeScale / pressureScale，改变它们相当于双对数曲线的平移，
+    // 无因次曲线 pD(tD) 不变。是纯缩放参数时返回 true 并给出两个幂次；kf、L 还进入 M12、LfD，不属于此类
+    static bool scalingExponents(ModelParams::Id id, int& timeExponent, int& pressureExponent);
+
+    // 静态工具: 生成对数时间步长
+    static QVector<double> generateLogTimeSteps(int count, double startExp, double endExp);
+
+private:
+    // 单元测试直接取拉氏空间参数并调用储层响应，比较 Toeplitz 递推与稠密求解
+    friend class TestCompositeModelSolver;
+
+    typedef std::complex<double> Complex;
+    // 自动微分用的对偶数 (Stehfest 实轴节点 / 复平面节点)
+    typedef DualNumber<double, LaplaceSensitivityCount> DualReal;
+    typedef DualNumber<Complex, LaplaceSensitivityCount> DualComplex;
+
+    // 拉氏空间参数的标量类型: 普通求值为 double，对偶数求值时与拉氏变量同类型 (可设为自变量)
+    template<typename T> struct ParamType { typedef double Type; };
+    template<typename S, int N> struct ParamType<DualNumber<S, N>> { typedef DualNumber<S, N> Type; };
+
+    // 外边界类型 (拉氏空间解的模板参数)
+    enum BoundaryType {
+        InfiniteBoundary,        // 模型 1/2: mAB = 0
+        ClosedBoundary,          // 模型 3/4: mAB = K1(re)/I1(re)
+        ConstantPressureBoundary // 模型 5/6: mAB = -K0(re)/I0(re)
+    };
+
+    // 裂缝条数不超过该值时，Toeplitz 求解的工作数组放在栈上
+    static const int kMaxStackFractures = 32;
+
+    // 一条曲线内所有拉氏节点共享的参数 (由 ModelParams 预先取出，裂缝位置只生成一次)
+    struct LaplaceParams {
+        double M12, LfD, rmD, reD;
+        double omega1, omega2, lambda1;
+        double cD, S;
+        int nf;
+        QVector<double> xwD, ywD;
+        bool uniformGrid; // 等间距且共线，影响矩阵为对称 Toeplitz 矩阵
+        // 自动微分时各参数对应的导数序号 (-1 表示按常数处理) 与方向数，普通求值时不使用
+        int slot[LaplaceSensitivityCount];
+        int directionCount;
+        double quadratureTolerance; // 影响系数自适应积分的容差 (取自反演计划)
+        const CancellationToken* cancellation; // 取消令牌 (取自 ParallelOptions)，为空表示不可取消
+    };
+    static LaplaceParams prepareLaplaceParams(const ModelParams& p, double quadratureTolerance);
+    // 取拉氏空间参数: P 为 double 时即 value，为对偶数时按 lp.slot 设为自变量
+    template<typename P>
+    static P laplaceParam(const LaplaceParams& lp, Sensitivity s, double value);
+
+    // 粗网格模式: 在自适应对数网格上计算后插值到 time (time 中的正值时间)
+    ModelCurveData calculateOnCoarseGrid(const ModelParams& params, const QVector<double>& time,
+                                         const SolverOptions& options, InversionStats* stats) const;
+
+    // 数学计算核心 (数值反演循环)，tD = timeScale * plan.time()；按 m_type 分派到对应的特化版本
+    void calculatePDandDeriv(const InversionPlan& plan, double timeScale, const ModelParams& params,
+                             QVector<double>& outPD, QVector<double>& outDeriv, InversionStats* stats,
+                             const ParallelOptions& parallel) const;
+    // responseCache 非空时先查找同一储层参数下的 p̄wD(z)，命中则只重新施加井储表皮并反演
+    template<BoundaryType Boundary, bool Storage>
+    static void calculatePDandDerivImpl(const InversionPlan& plan, double timeScale, const ModelParams& params,
+                                        QVector<double>& outPD, QVector<double>& outDeriv, InversionStats* stats,
+                                        const ParallelOptions& parallel, int modelType, ReservoirResponseCache* responseCache);
+    // 对偶数求值的反演循环: 输出无因次压力、导数及其对 directions 的偏导数 (已施加压敏变换)
+    template<BoundaryType Boundary, bool Storage>
+    static void calculateSensitivityImpl(const InversionPlan& plan, double timeScale, const ModelParams& params,
+                                         const QVector<Sensitivity>& directions,
+                                         QVector<double>& outPD, QVector<double>& outDeriv,
+                                         QVector<QVector<double>>& outPDSens, QVector<QVector<double>>& outDerivSens,
+                                         InversionStats* stats, const ParallelOptions& parallel);
+
+    // 拉普拉斯空间解分两层，T 为 double (Stehfest 实轴节点) 或 Complex:
+    // 储层响应 p̄wD(z) 包含全部贝塞尔函数与裂缝影响系数的计算，只取决于储层参数；
+    // 井储表皮只是 p̄wD(z) 之上的代数变换，Storage 为 true 时叠加 (模型 1/3/5)
+    template<BoundaryType Boundary, typename T>
+    static T reservoirResponse(const T& z, const LaplaceParams& lp);
+    template<bool Storage, typename T>
+    static T applyWellbore(const T& z, const T& pwd, const LaplaceParams& lp);
+
+    // PWD 核心计算 (包含边界条件处理 Logic from MATLAB PWD_inf)
+    template<BoundaryType Boundary, typename T>
+    static T PWD_composite(const T& z, const T& fs1, const T& fs2, const LaplaceParams& lp);
+
+    // 相对位置 (dx, dy) 处裂缝段的影响系数 (积分核 K0 + Ac*I0 沿裂缝半长积分后除以 M12*2*LfD)
+    // 实数: 自身与相邻段由累积积分表查表相减，远处段用定阶 Gauss 积分；复数: 自适应 Gauss 积分
+    // eps 为自适应积分的容差
+    static double influenceCoefficient(double gama1, double arg_g1_rm, double Ac_prefactor, double M12, double LfD,
+                                       double dx, double dy, double eps);
+    static Complex influenceCoefficient(const Complex& gama1, const Complex& arg_g1_rm, const Complex& Ac_prefactor,
+                                        double M12, double LfD, double dx, double dy, double eps);
+    static DualReal influenceCoefficient(const DualReal& gama1, const DualReal& arg_g1_rm, const DualReal& Ac_prefactor,
+                                         const DualReal& M12, const DualReal& LfD, double dx, double dy, double eps);
+    static DualComplex influenceCoefficient(const DualComplex& gama1, const DualComplex& arg_g1_rm, const DualComplex& Ac_prefactor,
+                                            const DualComplex& M12, const DualComplex& LfD, double dx, double dy, double eps);
+    template<typename R>
+    static R influenceByTable(const R& gama1, const R& arg_g1_rm, const R& Ac_prefactor, const R& M12, const R& LfD,
+                              double dx, double dy, double eps);
+    // P 为对偶数时积分限 ±LfD 也是自变量，按 Leibniz 公式补上端点项
+    template<typename T, typename P>
+    static T influenceByQuadrature(const T& gama1, const T& arg_g1_rm, const T& Ac_prefactor, const P& M12, const P& LfD,
+                                   double dx, double dy, double eps);
+
+    // 裂缝是否位于等间距 xwD 网格且 ywD 全为 0 (此时影响矩阵为对称 Toeplitz 矩阵)
+    static bool isUniformFractureGrid(const QVector<double>& xwD, const QVector<double>& ywD);
+    // Levinson 递推求解对称 Toeplitz 方程组，主元过小时返回 false
+    template<typename T>
+    static bool solveSymmetricToeplitz(const T* column, const T* rhs, int n, T* x);
+    // 稠密 LU 求解加边方程组 [A -1; z*1^T 0][q; p] = [0; 1]，返回 p (A 为 nf*nf 行主序影响矩阵)
+    // 对偶数时只分解一次数值矩阵，各方向的导数由 x' = -M^-1 M' x 回代得到
+    template<typename T>
+    static T solveBorderedSystem(const T* influence, int nf, const T& z);
+
+    // 数学工具函数 (对应 MATLAB 内置函数或逻辑)，均为无状态纯函数
+    // 同一宗量的 K0, K1 (不缩放) 与 I0, I1 (乘 e^-x 缩放)，由 BesselFunctions 一次算出
+    template<typename T>
+    static void besselKI(const T& x, T& k0, T& k1, T& i0s, T& i1s);
+    // 15 点 Gauss 积分，被积函数按面板批量求值: f(const double* a, int n, T* out)
+    template<typename T, typename Func>
+    static T gauss15(const Func& f, double a, double b);
+    template<typename T, typename Func>
+    static T adaptiveGauss(const Func& f, double a, double b, double eps, int depth, int maxDepth);
+
+private:
+    ModelType m_type;
+    // 拉氏空间储层响应缓存 (内部加锁；求解器复制时共享同一缓存)
+    QSharedPointer<ReservoirResponseCache> m_responseCache;
+};
+
+#endif // COMPOSITEMODELSOLVER_H
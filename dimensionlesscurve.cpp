@@ -0,0 +1,163 @@
+/*
+ * dimensionlesscurve.cpp
+ * 文件作用：拟合用无因次理论曲线缓存实现
+ * 功能描述：
+ * 1. 有因次曲线与无因次曲线的相互换算 (tD = timeScale * t，p = pressureScale * pD)
+ * 2. 无因次曲线在 (ln tD, ln pD)、(ln tD, ln dD) 空间用保单调三次插值
+ */
+
+#include "dimensionlesscurve.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// 判断覆盖范围时允许的 ln tD 舍入误差
+const double kRangeSlack = 1e-9;
+
+MonotoneCubicInterpolator buildInterpolator(const QVector<double>& x, const QVector<double>& v, bool& logY)
+{
+    logY = true;
+    for (double y : v) {
+        if (!(y > 0.0)) { logY = false; break; }
+    }
+    QVector<double> y(v.size());
+    for (int i = 0; i < v.size(); ++i) y[i] = logY ? std::log(v[i]) : v[i];
+    return MonotoneCubicInterpolator(x, y);
+}
+}
+
+DimensionlessCurve::DimensionlessCurve()
+    : m_timeScale(0.0), m_pressureScale(0.0),
+      m_pressure(QVector<double>(), QVector<double>()), m_derivative(QVector<double>(), QVector<double>()),
+      m_logPressure(false), m_logDerivative(false)
+{
+}
+
+DimensionlessCurve::DimensionlessCurve(const ModelParams& params, const ModelCurveData& curve)
+    : m_shape(params),
+      m_timeScale(CompositeModelSolver::timeScale(params)),
+      m_pressureScale(CompositeModelSolver::pressureScale(params)),
+      m_pressure(QVector<double>(), QVector<double>()), m_derivative(QVector<double>(), QVector<double>()),
+      m_logPressure(false), m_logDerivative(false)
+{
+    if (!(m_timeScale > 0.0) || !std::isfinite(m_timeScale) || m_pressureScale == 0.0 || !std::isfinite(m_pressureScale)) return;
+    appendPoints(curve);
+    rebuild();
+}
+
+bool DimensionlessCurve::hasSameShape(const ModelParams& params) const
+{
+    if (!isValid()) return false;
+    int timeExponent, pressureExponent;
+    for (int i = 0; i < ModelParams::Count; ++i) {
+        ModelParams::Id id = ModelParams::Id(i);
+        if (CompositeModelSolver::scalingExponents(id, timeExponent, pressureExponent)) continue;
+        if (params.contains(id) != m_shape.contains(id) || params[id] != m_shape[id]) return false;
+    }
+    return true;
+}
+
+bool DimensionlessCurve::evaluate(const ModelParams& params, const QVector<double>& time, ModelCurveData& out) const
+{
+    if (!isValid()) return false;
+    double timeScale = CompositeModelSolver::timeScale(params);
+    double pressureScale = CompositeModelSolver::pressureScale(params);
+    if (!(timeScale > 0.0) || !std::isfinite(timeScale) || !std::isfinite(pressureScale)) return false;
+
+    double lnScale = std::log(timeScale);
+    double lnMin = m_lnTD.first() - kRangeSlack, lnMax = m_lnTD.last() + kRangeSlack;
+    QVector<double> p(time.size(), 0.0), d(time.size(), 0.0);
+    for (int i = 0; i < time.size(); ++i) {
+        // 非正时间保持为 0 (与求解器逐点计算一致)
+        if (time[i] <= 0.0) continue;
+        double x = std::log(time[i]) + lnScale;
+        if (x < lnMin || x > lnMax) return false;
+        double pD = m_pressure.value(x), dD = m_derivative.value(x);
+        p[i] = pressureScale * (m_logPressure ? std::exp(pD) : pD);
+        d[i] = pressureScale * (m_logDerivative ? std::exp(dD) : dD);
+    }
+    out = std::make_tuple(time, p, d);
+    return true;
+}
+
+QVector<double> DimensionlessCurve::extensionTimes(const ModelParams& params, const QVector<double>& time, int pointsPerDecade) const
+{
+    QVector<double> ext;
+    if (!isValid()) return ext;
+    double timeScale = CompositeModelSolver::timeScale(params);
+    if (!(timeScale > 0.0) || !std::isfinite(timeScale)) return ext;
+
+    // 所需的 ln tD 范围
+    double need0 = 0.0, need1 = 0.0;
+    bool any = false;
+    for (double t : time) {
+        if (t <= 0.0) continue;
+        double x = std::log(t * timeScale);
+        if (!any) { need0 = need1 = x; any = true; }
+        need0 = std::min(need0, x);
+        need1 = std::max(need1, x);
+    }
+    if (!any) return ext;
+
+    // 在 [from, to] 上按对数等距取点 (不含已有的端点 from)，换算回 shapeParams() 下的时间
+    double step = std::log(10.0) / std::max(1, pointsPerDecade);
+    double lnShapeScale = std::log(m_timeScale);
+    auto appendRange = [&](double from, double to) {
+        int n = std::max(1, int(std::ceil(std::abs(to - from) / step)));
+        for (int k = 1; k <= n; ++k) ext.append(std::exp(from + (to - from) * k / n - lnShapeScale));
+    };
+    if (need0 < m_lnTD.first() - kRangeSlack) appendRange(m_lnTD.first(), need0);
+    if (need1 > m_lnTD.last() + kRangeSlack) appendRange(m_lnTD.last(), need1);
+    return ext;
+}
+
+void DimensionlessCurve::merge(const ModelCurveData& curve)
+{
+    if (!isValid()) return;
+    appendPoints(curve);
+    rebuild();
+}
+
+void DimensionlessCurve::appendPoints(const ModelCurveData& curve)
+{
+    const QVector<double>& t = std::get<0>(curve);
+    const QVector<double>& p = std::get<1>(curve);
+    const QVector<double>& d = std::get<2>(curve);
+    int n = qMin(t.size(), qMin(p.size(), d.size()));
+    for (int i = 0; i < n; ++i) {
+        if (!(t[i] > 0.0) || !std::isfinite(p[i]) || !std::isfinite(d[i])) continue;
+        Node node;
+        node.lnTD = std::log(t[i] * m_timeScale);
+        node.pD = p[i] / m_pressureScale;
+        node.dD = d[i] / m_pressureScale;
+        if (std::isfinite(node.lnTD)) m_nodes.append(node);
+    }
+}
+
+void DimensionlessCurve::rebuild()
+{
+    std::stable_sort(m_nodes.begin(), m_nodes.end());
+    // 插值要求横坐标严格递增，重复时间只保留第一个
+    QVector<Node> unique;
+    unique.reserve(m_nodes.size());
+    for (const Node& node : m_nodes) {
+        if (unique.isEmpty() || node.lnTD > unique.last().lnTD) unique.append(node);
+    }
+    m_nodes = unique;
+
+    int n = m_nodes.size();
+    m_lnTD.resize(n);
+    QVector<double> pD(n), dD(n);
+    for (int i = 0; i < n; ++i) {
+        m_lnTD[i] = m_nodes[i].lnTD;
+        pD[i] = m_nodes[i].pD;
+        dD[i] = m_nodes[i].dD;
+    }
+    if (n < 2) {
+        m_lnTD.clear();
+        return;
+    }
+    m_pressure = buildInterpolator(m_lnTD, pD, m_logPressure);
+    m_derivative = buildInterpolator(m_lnTD, dD, m_logDerivative);
+}
@@ -0,0 +1,65 @@
+/*
+ * dimensionlesscurve.h
+ * 文件作用：拟合用无因次理论曲线缓存头文件
+ * 功能描述：
+ * 1. 保存一组"形状参数" (除 phi, mu, Ct, h, q, B 以外的全部参数) 下的无因次曲线 pD(tD)、tD*dpD/dtD
+ * 2. 纯缩放参数只改变 tD 与压差的换算系数，在双对数坐标中表现为曲线平移；
+ *    形状参数相同的任意参数组合，其理论曲线都可由本曲线在 (ln tD, ln pD) 空间插值得到，无需再做数值反演
+ * 3. 曲线点来自已经算好的有因次理论曲线 (通常就是拟合当前点在观测时间上的曲线)，
+ *    平移后超出覆盖范围时由调用方补算两端并合并
+ */
+
+#ifndef DIMENSIONLESSCURVE_H
+#define DIMENSIONLESSCURVE_H
+
+#include <QVector>
+#include "compositemodelsolver.h"
+#include "monotonecubicinterpolator.h"
+
+class DimensionlessCurve
+{
+public:
+    DimensionlessCurve();
+    // 由参数 params 下在时间 curve 上算得的理论曲线构建 (时间无需有序，非正时间与非有限值被忽略)
+    DimensionlessCurve(const ModelParams& params, const ModelCurveData& curve);
+
+    bool isValid() const { return m_lnTD.size() >= 2; }
+    const ModelParams& shapeParams() const { return m_shape; }
+
+    // params 与构建曲线时的参数只在纯缩放参数上不同
+    bool hasSameShape(const ModelParams& params) const;
+
+    // 按 params 的换算系数重构时间 time 上的曲线 (只对 hasSameShape 为 true 的参数有意义)；
+    // 有时间点超出覆盖范围时返回 false，out 不变
+    bool evaluate(const ModelParams& params, const QVector<double>& time, ModelCurveData& out) const;
+
+    // 为覆盖 params 下的时间 time 还需补算的时间点 (按 shapeParams() 的时间换算给出，两端各按 pointsPerDecade 取对数等距点)；
+    // 已完全覆盖时返回空
+    QVector<double> extensionTimes(const ModelParams& params, const QVector<double>& time, int pointsPerDecade) const;
+    // 合并 shapeParams() 下补算的曲线点
+    void merge(const ModelCurveData& curve);
+
+private:
+    // 将有因次曲线点换算为无因次点并追加
+    void appendPoints(const ModelCurveData& curve);
+    // 按 ln tD 排序去重后重建插值函数
+    void rebuild();
+
+    struct Node {
+        double lnTD, pD, dD;
+        bool operator<(const Node& other) const { return lnTD < other.lnTD; }
+    };
+
+    ModelParams m_shape;
+    double m_timeScale;
+    double m_pressureScale;
+    QVector<Node> m_nodes;
+    QVector<double> m_lnTD;
+    // 数值全为正时在对数空间插值
+    MonotoneCubicInterpolator m_pressure;
+    MonotoneCubicInterpolator m_derivative;
+    bool m_logPressure;
+    bool m_logDerivative;
+};
+
+#endif // DIMENSIONLESSCURVE_H
@@ -0,0 +1,230 @@
+/*
+ * dualnumber.h
+ * 文件作用：前向自动微分用的对偶数类型
+ * 功能描述：
+ * 1. DualNumber<T, N>: 值 T (double 或 std::complex<double>) 与至多 N 个方向的一阶偏导数
+ * 2. 实际使用的方向数在运行期确定 (count)，运算只遍历这些方向；常数的方向数为 0。
+ *    同一次求值中的全部变量使用相同的方向数，两个非常数操作数的方向数必须相同
+ * 3. 提供四则运算、sqrt / exp / log / abs / real，以及 compose() 链式法则工具，
+ *    供贝塞尔函数、累积积分表等已知导数的函数直接组装对偶数结果
+ * 4. 实值对偶数的比较运算只比较值，使模板化的数值内核中的分支判断保持不变
+ * 5. DualTraits 统一普通标量与对偶数的取值、设定自变量接口，模板内核对两者写法相同
+ */
+
+#ifndef DUALNUMBER_H
+#define DUALNUMBER_H
+
+#include <cmath>
+#include <complex>
+#include <type_traits>
+
+template<typename T, int N>
+class DualNumber
+{
+public:
+    DualNumber() : m_value(0.0), m_count(0) {}
+    // 常数 (T 本身或可转换为 T 的实数)
+    template<typename S, typename = typename std::enable_if<std::is_convertible<S, T>::value>::type>
+    DualNumber(const S& value) : m_value(value), m_count(0) {}
+
+    // 直接给定值与 count 个方向的导数
+    DualNumber(const T& value, const T* derivatives, int count) : m_value(value), m_count(count)
+    {
+        for (int i = 0; i < count; ++i) m_d[i] = derivatives[i];
+    }
+
+    // 第 slot 个方向的自变量 (该方向导数为 1)，count 为本次求值的方向数
+    static DualNumber variable(const T& value, int slot, int count)
+    {
+        DualNumber r(value);
+        r.m_count = count;
+        for (int i = 0; i < count; ++i) r.m_d[i] = T(0.0);
+        r.m_d[slot] = T(1.0);
+        return r;
+    }
+
+    // 链式法则: 返回值为 f、对 x 的导数为 dfdx 的对偶数，即 f(x) 的对偶数结果
+    static DualNumber compose(const DualNumber& x, const T& f, const T& dfdx)
+    {
+        DualNumber r(f);
+        r.m_count = x.m_count;
+        for (int i = 0; i < x.m_count; ++i) r.m_d[i] = dfdx * x.m_d[i];
+        return r;
+    }
+
+    const T& value() const { return m_value; }
+    int count() const { return m_count; }
+    // 第 i 个方向的偏导数 (i 超出方向数时为 0)
+    T derivative(int i) const { return i < m_count ? m_d[i] : T(0.0); }
+
+    DualNumber operator-() const
+    {
+        DualNumber r(-m_value);
+        r.m_count = m_count;
+        for (int i = 0; i < m_count; ++i) r.m_d[i] = -m_d[i];
+        return r;
+    }
+
+    DualNumber& operator+=(const DualNumber& o)
+    {
+        m_value += o.m_value;
+        if (o.m_count == 0) return *this;
+        if (m_count == 0) {
+            m_count = o.m_count;
+            for (int i = 0; i < m_count; ++i) m_d[i] = o.m_d[i];
+        } else {
+            for (int i = 0; i < m_count; ++i) m_d[i] += o.m_d[i];
+        }
+        return *this;
+    }
+    DualNumber& operator-=(const DualNumber& o)
+    {
+        m_value -= o.m_value;
+        if (o.m_count == 0) return *this;
+        if (m_count == 0) {
+            m_count = o.m_count;
+            for (int i = 0; i < m_count; ++i) m_d[i] = -o.m_d[i];
+        } else {
+            for (int i = 0; i < m_count; ++i) m_d[i] -= o.m_d[i];
+        }
+        return *this;
+    }
+    DualNumber& operator*=(const DualNumber& o)
+    {
+        if (o.m_count == 0) {
+            for (int i = 0; i < m_count; ++i) m_d[i] *= o.m_value;
+        } else if (m_count == 0) {
+            m_count = o.m_count;
+            for (int i = 0; i < m_count; ++i) m_d[i] = m_value * o.m_d[i];
+        } else {
+            for (int i = 0; i < m_count; ++i) m_d[i] = m_d[i] * o.m_value + m_value * o.m_d[i];
+        }
+        m_value *= o.m_value;
+        return *this;
+    }
+    DualNumber& operator/=(const DualNumber& o)
+    {
+        T inv = T(1.0) / o.m_value;
+        m_value *= inv;
+        // (a/b)' = (a' - (a/b) b') / b
+        if (o.m_count == 0) {
+            for (int i = 0; i < m_count; ++i) m_d[i] *= inv;
+        } else if (m_count == 0) {
+            m_count = o.m_count;
+            for (int i = 0; i < m_count; ++i) m_d[i] = -m_value * o.m_d[i] * inv;
+        } else {
+            for (int i = 0; i < m_count; ++i) m_d[i] = (m_d[i] - m_value * o.m_d[i]) * inv;
+        }
+        return *this;
+    }
+
+private:
+    T m_value;
+    T m_d[N];
+    int m_count;
+};
+
+// ---- 四则运算 (对偶数与对偶数、对偶数与可转换为 T 的标量) ----
+template<typename T, int N>
+DualNumber<T, N> operator+(DualNumber<T, N> a, const DualNumber<T, N>& b) { return a += b; }
+template<typename T, int N>
+DualNumber<T, N> operator-(DualNumber<T, N> a, const DualNumber<T, N>& b) { return a -= b; }
+template<typename T, int N>
+DualNumber<T, N> operator*(DualNumber<T, N> a, const DualNumber<T, N>& b) { return a *= b; }
+template<typename T, int N>
+DualNumber<T, N> operator/(DualNumber<T, N> a, const DualNumber<T, N>& b) { return a /= b; }
+
+#define DUALNUMBER_SCALAR_OPERATOR(op)                                                                      \
+    template<typename T, int N, typename S,                                                                 \
+             typename = typename std::enable_if<std::is_convertible<S, T>::value>::type>                   \
+    DualNumber<T, N> operator op(const DualNumber<T, N>& a, const S& b) { return a op DualNumber<T, N>(b); } \
+    template<typename T, int N, typename S,                                                                 \
+             typename = typename std::enable_if<std::is_convertible<S, T>::value>::type>                   \
+    DualNumber<T, N> operator op(const S& a, const DualNumber<T, N>& b) { return DualNumber<T, N>(a) op b; }
+DUALNUMBER_SCALAR_OPERATOR(+)
+DUALNUMBER_SCALAR_OPERATOR(-)
+DUALNUMBER_SCALAR_OPERATOR(*)
+DUALNUMBER_SCALAR_OPERATOR(/)
+#undef DUALNUMBER_SCALAR_OPERATOR
+
+// ---- 初等函数 ----
+template<typename T, int N>
+DualNumber<T, N> sqrt(const DualNumber<T, N>& x)
+{
+    using std::sqrt;
+    T s = sqrt(x.value());
+    return DualNumber<T, N>::compose(x, s, T(0.5) / s);
+}
+
+template<typename T, int N>
+DualNumber<T, N> exp(const DualNumber<T, N>& x)
+{
+    using std::exp;
+    T e = exp(x.value());
+    return DualNumber<T, N>::compose(x, e, e);
+}
+
+template<typename T, int N>
+DualNumber<T, N> log(const DualNumber<T, N>& x)
+{
+    using std::log;
+    return DualNumber<T, N>::compose(x, log(x.value()), T(1.0) / x.value());
+}
+
+// 实值: |x| 仍为对偶数 (导数乘以符号)；复值: 只返回模，供收敛与奇异判断使用
+template<int N>
+DualNumber<double, N> abs(const DualNumber<double, N>& x)
+{
+    return x.value() < 0.0 ? -x : x;
+}
+template<int N>
+double abs(const DualNumber<std::complex<double>, N>& x)
+{
+    return std::abs(x.value());
+}
+
+template<typename T, int N>
+double real(const DualNumber<T, N>& x)
+{
+    return std::real(x.value());
+}
+
+// ---- 实值对偶数的比较 (只比较值) ----
+#define DUALNUMBER_COMPARISON(op)                                                                          \
+    template<int N>                                                                                        \
+    bool operator op(const DualNumber<double, N>& a, const DualNumber<double, N>& b) { return a.value() op b.value(); } \
+    template<int N>                                                                                        \
+    bool operator op(const DualNumber<double, N>& a, double b) { return a.value() op b; }                 \
+    template<int N>                                                                                        \
+    bool operator op(double a, const DualNumber<double, N>& b) { return a op b.value(); }
+DUALNUMBER_COMPARISON(<)
+DUALNUMBER_COMPARISON(>)
+DUALNUMBER_COMPARISON(<=)
+DUALNUMBER_COMPARISON(>=)
+#undef DUALNUMBER_COMPARISON
+
+// ---- 普通标量与对偶数的统一接口 ----
+template<typename T>
+struct DualTraits
+{
+    static const bool isDual = false;
+    typedef T Scalar;
+    // 设定自变量: 普通标量忽略方向，直接返回数值
+    static T seed(double value, int /*slot*/, int /*count*/) { return T(value); }
+    static const T& value(const T& x) { return x; }
+};
+
+template<typename T, int N>
+struct DualTraits<DualNumber<T, N>>
+{
+    static const bool isDual = true;
+    typedef T Scalar;
+    // slot < 0 表示该输入不是本次求导的方向，按常数处理
+    static DualNumber<T, N> seed(double value, int slot, int count)
+    {
+        return slot >= 0 ? DualNumber<T, N>::variable(T(value), slot, count) : DualNumber<T, N>(value);
+    }
+    static const T& value(const DualNumber<T, N>& x) { return x.value(); }
+};
+
+#endif // DUALNUMBER_H
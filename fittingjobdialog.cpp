@@ -0,0 +1,131 @@
+/*
+ * fittingjobdialog.cpp
+ * 文件作用：拟合任务队列窗口的具体实现
+ * 功能描述：
+ * 1. 表格显示调度器中的任务，任务变化时立即刷新，运行时长与预计剩余时间每秒刷新
+ * 2. 上移、下移、取消与清除已结束任务的按钮操作
+ * 3. 同时运行任务数与线程总数的设置直接交给调度器 (由其保存)
+ */
+
+#include "fittingjobdialog.h"
+#include "ui_fittingjobdialog.h"
+#include <QHeaderView>
+#include <QTableWidgetItem>
+
+FittingJobDialog::FittingJobDialog(FittingJobScheduler* scheduler, QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::FittingJobDialog),
+    m_scheduler(scheduler)
+{
+    ui->setupUi(this);
+    this->setWindowTitle("拟合任务队列");
+
+    QStringList headers;
+    headers << "编号" << "分析" << "任务" << "状态" << "进度" << "已运行" << "预计剩余";
+    ui->tableWidget->setColumnCount(headers.size());
+    ui->tableWidget->setHorizontalHeaderLabels(headers);
+    ui->tableWidget->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    ui->tableWidget->setSelectionBehavior(QAbstractItemView::SelectRows);
+    ui->tableWidget->setSelectionMode(QAbstractItemView::SingleSelection);
+    ui->tableWidget->verticalHeader()->setVisible(false);
+    ui->tableWidget->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Stretch);
+
+    ui->spinMaxJobs->setValue(m_scheduler->maxConcurrentJobs());
+    ui->spinThreadBudget->setValue(m_scheduler->threadBudget());
+    connect(ui->spinMaxJobs, QOverload<int>::of(&QSpinBox::valueChanged), m_scheduler, &FittingJobScheduler::setMaxConcurrentJobs);
+    connect(ui->spinThreadBudget, QOverload<int>::of(&QSpinBox::valueChanged), m_scheduler, &FittingJobScheduler::setThreadBudget);
+
+    connect(ui->btnMoveUp, &QPushButton::clicked, this, &FittingJobDialog::onMoveUp);
+    connect(ui->btnMoveDown, &QPushButton::clicked, this, &FittingJobDialog::onMoveDown);
+    connect(ui->btnCancelJob, &QPushButton::clicked, this, &FittingJobDialog::onCancelJob);
+    connect(ui->btnClearFinished, &QPushButton::clicked, m_scheduler, &FittingJobScheduler::removeFinishedJobs);
+    connect(ui->btnClose, &QPushButton::clicked, this, &FittingJobDialog::close);
+    connect(ui->tableWidget, &QTableWidget::itemSelectionChanged, this, &FittingJobDialog::updateButtons);
+
+    connect(m_scheduler, &FittingJobScheduler::jobsChanged, this, &FittingJobDialog::refreshTable);
+    m_refreshTimer.setInterval(1000);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &FittingJobDialog::refreshTable);
+    m_refreshTimer.start();
+
+    refreshTable();
+}
+
+FittingJobDialog::~FittingJobDialog()
+{
+    delete ui;
+}
+
+QString FittingJobDialog::formatDuration(qint64 ms)
+{
+    if(ms < 0) return "-";
+    qint64 s = ms / 1000;
+    return QString("%1:%2:%3").arg(s / 3600).arg((s / 60) % 60, 2, 10, QChar('0')).arg(s % 60, 2, 10, QChar('0'));
+}
+
+int FittingJobDialog::selectedJobId() const
+{
+    QList<QTableWidgetItem*> items = ui->tableWidget->selectedItems();
+    if(items.isEmpty()) return 0;
+    QTableWidgetItem* idItem = ui->tableWidget->item(items.first()->row(), 0);
+    return idItem ? idItem->data(Qt::UserRole).toInt() : 0;
+}
+
+void FittingJobDialog::refreshTable()
+{
+    int selectedId = selectedJobId();
+    const QList<FittingJobScheduler::Job>& jobs = m_scheduler->jobs();
+
+    ui->tableWidget->blockSignals(true);
+    ui->tableWidget->setRowCount(jobs.size());
+    int selectedRow = -1;
+    for(int i = 0; i < jobs.size(); ++i) {
+        const FittingJobScheduler::Job& job = jobs[i];
+        QStringList cells;
+        cells << QString("#%1").arg(job.id)
+              << job.name
+              << job.description
+              << FittingJobScheduler::statusName(job.status)
+              << QString("%1%").arg(job.progress)
+              << (job.status == FittingJobScheduler::Queued ? "-" : formatDuration(job.runningMs()))
+              << (job.status == FittingJobScheduler::Queued ? "等待运行" : formatDuration(job.remainingMs()));
+        for(int c = 0; c < cells.size(); ++c) {
+            QTableWidgetItem* item = ui->tableWidget->item(i, c);
+            if(!item) { item = new QTableWidgetItem(); ui->tableWidget->setItem(i, c, item); }
+            item->setText(cells[c]);
+            item->setTextAlignment(c == 1 || c == 2 ? (Qt::AlignLeft | Qt::AlignVCenter) : Qt::Alignment(Qt::AlignCenter));
+        }
+        ui->tableWidget->item(i, 0)->setData(Qt::UserRole, job.id);
+        if(job.id == selectedId) selectedRow = i;
+    }
+    if(selectedRow >= 0) ui->tableWidget->selectRow(selectedRow);
+    else ui->tableWidget->clearSelection();
+    ui->tableWidget->blockSignals(false);
+
+    ui->labelSummary->setText(QString("运行 %1 | 排队 %2").arg(m_scheduler->runningCount()).arg(m_scheduler->queuedCount()));
+    updateButtons();
+}
+
+void FittingJobDialog::updateButtons()
+{
+    FittingJobScheduler::Status status = m_scheduler->status(selectedJobId());
+    bool queued = selectedJobId() > 0 && status == FittingJobScheduler::Queued;
+    bool active = selectedJobId() > 0 && (queued || status == FittingJobScheduler::Running);
+    ui->btnMoveUp->setEnabled(queued);
+    ui->btnMoveDown->setEnabled(queued);
+    ui->btnCancelJob->setEnabled(active);
+}
+
+void FittingJobDialog::onMoveUp()
+{
+    m_scheduler->moveJob(selectedJobId(), -1);
+}
+
+void FittingJobDialog::onMoveDown()
+{
+    m_scheduler->moveJob(selectedJobId(), 1);
+}
+
+void FittingJobDialog::onCancelJob()
+{
+    m_scheduler->cancel(selectedJobId());
+}
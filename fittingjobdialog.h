@@ -0,0 +1,49 @@
+#ifndef FITTINGJOBDIALOG_H
+#define FITTINGJOBDIALOG_H
+
+#include <QDialog>
+#include <QTimer>
+#include "fittingjobscheduler.h"
+
+namespace Ui {
+class FittingJobDialog;
+}
+
+// ===========================================================================
+// 类名：FittingJobDialog
+// 作用：拟合任务队列窗口 (非模态)
+// 功能：
+// 1. 列出各分析页提交的拟合任务及其状态、进度、运行时长与预计剩余时间 (每秒刷新)
+// 2. 排队中的任务可上移、下移；任意任务可取消；已结束的记录可清除
+// 3. 设置同时运行任务数与线程总数
+// ===========================================================================
+
+class FittingJobDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit FittingJobDialog(FittingJobScheduler* scheduler, QWidget *parent = nullptr);
+    ~FittingJobDialog();
+
+    // 时长显示为 时:分:秒，负值 (未知) 显示为 "-"
+    static QString formatDuration(qint64 ms);
+
+private:
+    Ui::FittingJobDialog *ui;
+    FittingJobScheduler* m_scheduler;
+    QTimer m_refreshTimer;
+
+    // 当前选中行对应的任务编号，未选择时返回 0
+    int selectedJobId() const;
+
+private slots:
+    // 按调度器的任务列表重建表格 (保持选中的任务)
+    void refreshTable();
+    void updateButtons();
+    void onMoveUp();
+    void onMoveDown();
+    void onCancelJob();
+};
+
+#endif // FITTINGJOBDIALOG_H
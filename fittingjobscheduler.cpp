@@ -0,0 +1,234 @@
+/*
+ * fittingjobscheduler.cpp
+ * 文件作用：拟合任务调度器的具体实现
+ * 功能描述：
+ * 1. 维护任务队列，按同时运行任务数上限启动排队中的任务，任务结束后自动补位
+ * 2. 每个运行中的任务独占一个线程池，线程总数在运行中的任务之间均分，任务增减时重新分配
+ * 3. 取消、调整顺序、进度汇报与预计剩余时间的估算
+ */
+
+#include "fittingjobscheduler.h"
+#include <QtConcurrent>
+#include <QSettings>
+#include <QThread>
+
+qint64 FittingJobScheduler::Job::runningMs() const
+{
+    if (status == Running) return clock.elapsed();
+    return elapsedMs;
+}
+
+qint64 FittingJobScheduler::Job::remainingMs() const
+{
+    if (status != Running) return status == Queued ? -1 : 0;
+    qint64 elapsed = clock.elapsed();
+    qint64 estimate = -1;
+    if (progress > 0 && progress < 100) estimate = elapsed * (100 - progress) / progress;
+    if (timeLimitMs > 0) {
+        qint64 limitLeft = qMax<qint64>(0, timeLimitMs - elapsed);
+        estimate = estimate < 0 ? limitLeft : qMin(estimate, limitLeft);
+    }
+    return estimate;
+}
+
+FittingJobScheduler::FittingJobScheduler(QObject *parent) :
+    QObject(parent),
+    m_nextId(1)
+{
+    QSettings settings("WellTestPro", "WellTestAnalysis");
+    m_maxConcurrentJobs = qMax(1, settings.value("FittingQueue/maxConcurrentJobs", 2).toInt());
+    m_threadBudget = qMax(1, settings.value("FittingQueue/threadBudget", QThread::idealThreadCount()).toInt());
+    // 运行中的任务数由 startQueuedJobs 控制，这里只需保证线程不少于任务数
+    m_runnerPool.setMaxThreadCount(256);
+}
+
+FittingJobScheduler::~FittingJobScheduler()
+{
+    for (Job& job : m_jobs) {
+        if (job.status == Queued) job.status = Cancelled;
+        job.cancellation.cancel();
+    }
+    m_runnerPool.waitForDone();
+    for (Job& job : m_jobs) delete job.pool;
+}
+
+int FittingJobScheduler::submit(const QString& name, const QString& description, const CancellationToken& cancellation, qint64 timeLimitMs,
+                                const std::function<void(QThreadPool*)>& task)
+{
+    Job job;
+    job.id = m_nextId++;
+    job.name = name;
+    job.description = description;
+    job.timeLimitMs = timeLimitMs;
+    job.cancellation = cancellation;
+    job.task = task;
+    m_jobs.append(job);
+    startQueuedJobs();
+    emit jobsChanged();
+    return job.id;
+}
+
+void FittingJobScheduler::cancel(int jobId)
+{
+    int index = indexOf(jobId);
+    if (index < 0) return;
+    Job& job = m_jobs[index];
+    job.cancellation.cancel();
+    if (job.status != Queued) return;
+    job.status = Cancelled;
+    job.task = nullptr;
+    emit jobDiscarded(jobId);
+    emit jobsChanged();
+}
+
+void FittingJobScheduler::cancelAndWait(int jobId)
+{
+    cancel(jobId);
+    int index = indexOf(jobId);
+    if (index >= 0 && m_jobs[index].status == Running) m_jobs[index].future.waitForFinished();
+}
+
+void FittingJobScheduler::moveJob(int jobId, int offset)
+{
+    // 只在排队中的任务之间交换顺序，运行中与已结束的任务保持原位
+    QVector<int> queued;
+    for (int i = 0; i < m_jobs.size(); ++i) {
+        if (m_jobs[i].status == Queued) queued.append(i);
+    }
+    int pos = -1;
+    for (int k = 0; k < queued.size(); ++k) {
+        if (m_jobs[queued[k]].id == jobId) pos = k;
+    }
+    if (pos < 0) return;
+    int target = qBound(0, pos + offset, queued.size() - 1);
+    if (target == pos) return;
+    m_jobs.move(queued[pos], queued[target]);
+    emit jobsChanged();
+}
+
+void FittingJobScheduler::removeFinishedJobs()
+{
+    for (int i = m_jobs.size() - 1; i >= 0; --i) {
+        if (m_jobs[i].status == Finished || m_jobs[i].status == Cancelled) m_jobs.removeAt(i);
+    }
+    emit jobsChanged();
+}
+
+void FittingJobScheduler::reportProgress(int jobId, int percent)
+{
+    int index = indexOf(jobId);
+    if (index < 0 || m_jobs[index].progress == percent) return;
+    m_jobs[index].progress = percent;
+    emit jobsChanged();
+}
+
+FittingJobScheduler::Status FittingJobScheduler::status(int jobId) const
+{
+    int index = indexOf(jobId);
+    return index < 0 ? Cancelled : m_jobs[index].status;
+}
+
+int FittingJobScheduler::runningCount() const
+{
+    int count = 0;
+    for (const Job& job : m_jobs) count += (job.status == Running);
+    return count;
+}
+
+int FittingJobScheduler::queuedCount() const
+{
+    int count = 0;
+    for (const Job& job : m_jobs) count += (job.status == Queued);
+    return count;
+}
+
+void FittingJobScheduler::setMaxConcurrentJobs(int count)
+{
+    m_maxConcurrentJobs = qMax(1, count);
+    saveSettings();
+    // 调小时运行中的任务继续运行，之后按新的上限补位
+    startQueuedJobs();
+    emit jobsChanged();
+}
+
+void FittingJobScheduler::setThreadBudget(int threads)
+{
+    m_threadBudget = qMax(1, threads);
+    saveSettings();
+    shareThreads();
+    emit jobsChanged();
+}
+
+QString FittingJobScheduler::statusName(Status status)
+{
+    switch (status) {
+    case Queued: return "排队中";
+    case Running: return "运行中";
+    case Finished: return "已完成";
+    case Cancelled: return "已取消";
+    default: return QString();
+    }
+}
+
+void FittingJobScheduler::onJobFinished(int jobId)
+{
+    int index = indexOf(jobId);
+    if (index < 0) return;
+    Job& job = m_jobs[index];
+    job.elapsedMs = job.clock.elapsed();
+    job.status = job.cancellation.isCancelled() ? Cancelled : Finished;
+    if (job.status == Finished) job.progress = 100;
+    job.task = nullptr;
+    delete job.pool;
+    job.pool = nullptr;
+    shareThreads();
+    startQueuedJobs();
+    emit jobsChanged();
+}
+
+int FittingJobScheduler::indexOf(int jobId) const
+{
+    for (int i = 0; i < m_jobs.size(); ++i) {
+        if (m_jobs[i].id == jobId) return i;
+    }
+    return -1;
+}
+
+void FittingJobScheduler::startQueuedJobs()
+{
+    int running = runningCount();
+    for (int i = 0; i < m_jobs.size() && running < m_maxConcurrentJobs; ++i) {
+        Job& job = m_jobs[i];
+        if (job.status != Queued) continue;
+        job.status = Running;
+        job.pool = new QThreadPool();
+        job.clock.start();
+        ++running;
+        shareThreads();
+
+        int id = job.id;
+        QThreadPool* pool = job.pool;
+        std::function<void(QThreadPool*)> task = job.task;
+        job.future = QtConcurrent::run(&m_runnerPool, [this, id, pool, task]() {
+            task(pool);
+            QMetaObject::invokeMethod(this, "onJobFinished", Qt::QueuedConnection, Q_ARG(int, id));
+        });
+    }
+}
+
+void FittingJobScheduler::shareThreads()
+{
+    int running = runningCount();
+    if (running == 0) return;
+    int share = qMax(1, m_threadBudget / running - 1);
+    for (Job& job : m_jobs) {
+        if (job.status == Running && job.pool) job.pool->setMaxThreadCount(share);
+    }
+}
+
+void FittingJobScheduler::saveSettings() const
+{
+    QSettings settings("WellTestPro", "WellTestAnalysis");
+    settings.setValue("FittingQueue/maxConcurrentJobs", m_maxConcurrentJobs);
+    settings.setValue("FittingQueue/threadBudget", m_threadBudget);
+}
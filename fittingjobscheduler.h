@@ -0,0 +1,106 @@
+/*
+ * fittingjobscheduler.h
+ * 文件作用：拟合任务调度器头文件
+ * 功能描述：
+ * 1. 各分析页的自动拟合统一提交到调度器排队，按 "同时运行任务数" 上限依次启动
+ * 2. 线程总数按运行中的任务均分，每个任务独占一个线程池，多个分析页同时拟合也不会超额占用处理器
+ * 3. 记录每个任务的状态、进度、运行时长与预计剩余时间，排队中的任务可调整顺序，任意任务可取消
+ * 4. 同时运行任务数与线程总数保存在 QSettings 中，重新启动程序后沿用
+ */
+
+#ifndef FITTINGJOBSCHEDULER_H
+#define FITTINGJOBSCHEDULER_H
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QThreadPool>
+#include <functional>
+#include "cancellationtoken.h"
+
+class FittingJobScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Status { Queued, Running, Finished, Cancelled };
+
+    // 拟合任务: task 在调度器的工作线程中运行，参数为该任务独占的线程池
+    struct Job {
+        int id;
+        QString name;                   // 所属分析页名称
+        QString description;            // 任务类型 (单模型拟合、多模型对比等)
+        Status status;
+        int progress;                   // 进度百分比 (由分析页汇报)
+        qint64 timeLimitMs;             // 运行时限 (毫秒，从开始运行时计)，< 0 表示不限时
+        CancellationToken cancellation;
+        std::function<void(QThreadPool*)> task;
+        QThreadPool* pool;              // 运行中独占的线程池
+        QFuture<void> future;
+        QElapsedTimer clock;            // 开始运行时启动
+        qint64 elapsedMs;               // 结束时的运行时长
+
+        Job() : id(0), status(Queued), progress(0), timeLimitMs(-1), pool(nullptr), elapsedMs(0) {}
+        // 已运行时长 (毫秒)
+        qint64 runningMs() const;
+        // 预计剩余时间 (毫秒): 按进度线性外推，不超过时限的剩余部分；未知时返回 -1
+        qint64 remainingMs() const;
+    };
+
+    explicit FittingJobScheduler(QObject *parent = nullptr);
+    // 取消全部任务并等待运行中的任务返回
+    ~FittingJobScheduler();
+
+    // 提交任务，返回任务编号；有空闲名额时立即开始运行
+    int submit(const QString& name, const QString& description, const CancellationToken& cancellation, qint64 timeLimitMs,
+               const std::function<void(QThreadPool*)>& task);
+    // 取消任务: 排队中的任务直接移出队列 (发出 jobDiscarded)，运行中的任务经取消令牌尽快结束
+    void cancel(int jobId);
+    // 取消任务并等待其返回 (分析页被删除前调用，任务函数之后不再访问该页)
+    void cancelAndWait(int jobId);
+    // 排队中的任务在队列中前移 (offset < 0) 或后移
+    void moveJob(int jobId, int offset);
+    // 移除已完成与已取消的任务记录
+    void removeFinishedJobs();
+    // 分析页汇报任务进度 (界面线程调用)
+    void reportProgress(int jobId, int percent);
+
+    Status status(int jobId) const;
+    const QList<Job>& jobs() const { return m_jobs; }
+    int runningCount() const;
+    int queuedCount() const;
+
+    int maxConcurrentJobs() const { return m_maxConcurrentJobs; }
+    int threadBudget() const { return m_threadBudget; }
+    void setMaxConcurrentJobs(int count);
+    void setThreadBudget(int threads);
+
+    static QString statusName(Status status);
+
+signals:
+    // 任务列表、状态或进度发生变化
+    void jobsChanged();
+    // 排队中的任务被取消，其任务函数不会运行
+    void jobDiscarded(int jobId);
+
+private slots:
+    // 任务函数返回后在界面线程中收尾，并启动排队中的任务
+    void onJobFinished(int jobId);
+
+private:
+    QList<Job> m_jobs;           // 提交顺序，排队中的任务按此顺序启动
+    int m_nextId;
+    int m_maxConcurrentJobs;
+    int m_threadBudget;
+    QThreadPool m_runnerPool;    // 运行任务函数本身的线程 (每个运行中的任务占一个)
+
+    int indexOf(int jobId) const;
+    void startQueuedJobs();
+    // 线程总数按运行中的任务均分；任务函数所在线程也参与计算，故各线程池少分一个线程
+    void shareThreads();
+    void saveSettings() const;
+};
+
+#endif // FITTINGJOBSCHEDULER_H
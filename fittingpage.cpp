@@ -1,6 +1,8 @@
 #include "fittingpage.h"
 #include "ui_fittingpage.h" // 【关键】必须包含这个由 uic 自动生成的头文件
 #include "wt_fittingwidget.h" // 【关键】引用改名后的拟合控件头文件
+#include "fittingjobscheduler.h"
+#include "fittingjobdialog.h"
 #include "modelparameter.h"
 #include <QInputDialog>
 #include <QMessageBox>
@@ -10,13 +12,27 @@
 FittingPage::FittingPage(QWidget *parent) :
     QWidget(parent),
     ui(new Ui::FittingPage), // 如果 ui_fittingpage.h 生成成功，这里就不会报错
-    m_modelManager(nullptr)
+    m_modelManager(nullptr),
+    m_jobDialog(nullptr)
 {
     ui->setupUi(this);
+
+    // 所有分析页的拟合统一排队，按线程预算运行
+    m_jobScheduler = new FittingJobScheduler(this);
+    connect(m_jobScheduler, &FittingJobScheduler::jobsChanged, this, &FittingPage::onJobsChanged);
+    onJobsChanged();
 }
 
 FittingPage::~FittingPage()
 {
+    // 分析页析构时取消并等待自己的拟合任务，须在调度器之前销毁；之后调度器不再有引用分析页的任务
+    delete m_jobDialog;
+    while(ui->tabWidget->count() > 0) {
+        QWidget* w = ui->tabWidget->widget(0);
+        ui->tabWidget->removeTab(0);
+        delete w;
+    }
+    delete m_jobScheduler;
     delete ui;
 }
 
@@ -56,6 +72,8 @@ FittingWidget* FittingPage::createNewTab(const QString &name, const QJsonObject
     // 创建 FittingWidget 实例
     FittingWidget* w = new FittingWidget(this);
     if(m_modelManager) w->setModelManager(m_modelManager);
+    w->setJobScheduler(m_jobScheduler);
+    w->setAnalysisName(name);
 
     connect(w, &FittingWidget::sigRequestSave, this, &FittingPage::onChildRequestSave);
 
@@ -126,9 +144,24 @@ void FittingPage::on_btnRenameAnalysis_clicked()
     QString newName = QInputDialog::getText(this, "重命名", "请输入新的分析名称:", QLineEdit::Normal, oldName, &ok);
     if(ok && !newName.isEmpty()) {
         ui->tabWidget->setTabText(idx, newName);
+        FittingWidget* w = qobject_cast<FittingWidget*>(ui->tabWidget->widget(idx));
+        if(w) w->setAnalysisName(newName);
     }
 }
 
+void FittingPage::on_btnJobQueue_clicked()
+{
+    if(!m_jobDialog) m_jobDialog = new FittingJobDialog(m_jobScheduler, this);
+    m_jobDialog->show();
+    m_jobDialog->raise();
+    m_jobDialog->activateWindow();
+}
+
+void FittingPage::onJobsChanged()
+{
+    ui->labelJobQueue->setText(QString("拟合任务: 运行 %1 | 排队 %2").arg(m_jobScheduler->runningCount()).arg(m_jobScheduler->queuedCount()));
+}
+
 void FittingPage::on_btnDeleteAnalysis_clicked()
 {
     int idx = ui->tabWidget->currentIndex();
@@ -8,6 +8,8 @@
 
 // 前置声明
 class FittingWidget;
+class FittingJobScheduler;
+class FittingJobDialog;
 
 namespace Ui {
 class FittingPage;
@@ -40,11 +42,16 @@ private slots:
     void on_btnNewAnalysis_clicked();
     void on_btnRenameAnalysis_clicked();
     void on_btnDeleteAnalysis_clicked();
+    void on_btnJobQueue_clicked();
     void onChildRequestSave();
+    void onJobsChanged(); // 刷新工具栏上的任务队列概况
 
 private:
     Ui::FittingPage *ui;
     ModelManager* m_modelManager;
+    // 各分析页共用的拟合任务调度器与任务队列窗口 (首次打开时创建)
+    FittingJobScheduler* m_jobScheduler;
+    FittingJobDialog* m_jobDialog;
 
     // 内部函数：创建新页签
     FittingWidget* createNewTab(const QString& name, const QJsonObject& initData = QJsonObject());
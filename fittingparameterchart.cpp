@@ -44,9 +44,17 @@ void FittingParameterChart::setModelManager(ModelManager *m)
 void FittingParameterChart::resetParams(ModelManager::ModelType type)
 {
     if(!m_modelManager) return;
-    m_params.clear();
+    m_params = defaultParameters(type);
+    refreshParamTable();
+}
+
+QList<FitParameter> FittingParameterChart::defaultParameters(ModelManager::ModelType type) const
+{
+    QList<FitParameter> params;
+    if(!m_modelManager) return params;
 
-    QMap<QString, double> defaultMap = m_modelManager->getDefaultParameters(type);
+    // 表格按参数名排序显示，在此处转换为具名参数表
+    QMap<QString, double> defaultMap = m_modelManager->getDefaultParameters(type).toMap();
     QMapIterator<QString, double> it(defaultMap);
     while(it.hasNext()) {
         it.next();
@@ -64,9 +72,26 @@ void FittingParameterChart::resetParams(ModelManager::ModelType type)
         QString symbol, uniSym, unit;
         getParamDisplayInfo(p.name, p.displayName, symbol, uniSym, unit);
         p.isVisible = true; // 默认显示
-        m_params.append(p);
+        params.append(p);
     }
-    refreshParamTable();
+    return params;
+}
+
+QList<FitParameter> FittingParameterChart::parametersForModel(ModelManager::ModelType type) const
+{
+    QMap<QString, FitParameter> current;
+    for(const auto& p : m_params) current.insert(p.name, p);
+
+    QList<FitParameter> params = defaultParameters(type);
+    for(auto& p : params) {
+        if(p.value == 0.0 || !current.contains(p.name)) continue;
+        const FitParameter& c = current[p.name];
+        if(c.value == 0.0) continue;
+        p.value = c.value; p.isFit = c.isFit;
+        p.min = c.min; p.max = c.max;
+        p.isVisible = c.isVisible;
+    }
+    return params;
 }
 
 QList<FitParameter> FittingParameterChart::getParameters() const
@@ -80,6 +105,17 @@ void FittingParameterChart::setParameters(const QList<FitParameter> &params)
     refreshParamTable();
 }
 
+ModelParams FittingParameterChart::toModelParams(const QList<FitParameter> &params)
+{
+    ModelParams mp;
+    for(const auto& p : params) {
+        int id = ModelParams::indexOf(p.name);
+        if(id >= 0) mp.set(ModelParams::Id(id), p.value);
+    }
+    mp.updateDerived();
+    return mp;
+}
+
 void FittingParameterChart::switchModel(ModelManager::ModelType newType)
 {
     QMap<QString, double> oldValues;
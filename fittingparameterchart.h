@@ -32,10 +32,18 @@ public:
     // 重置参数为默认值
     void resetParams(ModelManager::ModelType type);
 
+    // 指定模型的参数列表: 与当前参数同名者沿用数值、拟合标记与上下限，其余取默认值；
+    // 值为 0 的参数在所属模型中不起作用 (如恒定井储模型的 C、S)，不沿用也不参与拟合
+    QList<FitParameter> parametersForModel(ModelManager::ModelType type) const;
+
     // 获取/设置参数列表
     QList<FitParameter> getParameters() const;
     void setParameters(const QList<FitParameter>& params);
 
+    // 转换为求解器使用的定长参数 (按参数名对应，未知参数忽略，并更新派生参数 LfD)
+    static ModelParams toModelParams(const QList<FitParameter>& params);
+    ModelParams getModelParams() const { return toModelParams(m_params); }
+
     // 切换模型（保留公有参数值）
     void switchModel(ModelManager::ModelType newType);
 
@@ -53,6 +61,8 @@ private:
     ModelManager* m_modelManager;
     QList<FitParameter> m_params;
 
+    // 辅助函数：按模型默认参数生成参数列表 (均不拟合)
+    QList<FitParameter> defaultParameters(ModelManager::ModelType type) const;
     // 辅助函数：添加单行数据
     void addRowToTable(const FitParameter& p, int& serialNo, bool highlight);
 };
@@ -0,0 +1,227 @@
+/*
+ * laplaceinversion.h
+ * 文件作用：拉普拉斯数值反演工具头文件
+ * 功能描述：
+ * 1. 编译期 (constexpr) 生成 Gaver-Stehfest 权重表 V_i，覆盖 N = 4, 6, ..., 20
+ * 2. LaplaceInversion: 可替换的数值反演方法接口，提供
+ *    Gaver-Stehfest、Euler (Abate-Whitt)、定步长 Talbot、de Hoog 四种实现，
+ *    每种方法都给出拉氏空间求值次数与误差估计
+ * 3. InversionPlan: 针对固定时间网格与反演方法预先确定节点分组，
+ *    拟合过程中在同一观测时间网格上反复反演时只需构建一次
+ */
+
+#ifndef LAPLACEINVERSION_H
+#define LAPLACEINVERSION_H
+
+#include <QVector>
+#include <QString>
+#include <QSharedPointer>
+#include <complex>
+#include <algorithm>
+
+// ============================================================================
+// Gaver-Stehfest 权重表 (编译期计算)
+// V_i = (-1)^(i+N/2) * sum_{k=(i+1)/2}^{min(i,N/2)} k^(N/2) (2k)! / [(N/2-k)! k! (k-1)! (i-k)! (2k-i)!]
+// ============================================================================
+namespace StehfestDetail {
+
+constexpr int MinN = 4;
+constexpr int MaxN = 20;
+constexpr int RowCount = (MaxN - MinN) / 2 + 1;
+
+struct FactorialTable {
+    double v[2 * MaxN + 1];
+};
+
+constexpr FactorialTable buildFactorials()
+{
+    FactorialTable f{};
+    f.v[0] = 1.0;
+    for (int n = 1; n <= 2 * MaxN; ++n) f.v[n] = f.v[n - 1] * n;
+    return f;
+}
+
+constexpr FactorialTable factorials = buildFactorials();
+
+constexpr double intPow(double base, int exp)
+{
+    double r = 1.0;
+    for (int i = 0; i < exp; ++i) r *= base;
+    return r;
+}
+
+constexpr double coefficient(int i, int N)
+{
+    double s = 0.0;
+    int k1 = (i + 1) / 2;
+    int k2 = (i < N / 2) ? i : N / 2;
+    for (int k = k1; k <= k2; ++k) {
+        double num = intPow(k, N / 2) * factorials.v[2 * k];
+        double den = factorials.v[N / 2 - k] * factorials.v[k] * factorials.v[k - 1]
+                   * factorials.v[i - k] * factorials.v[2 * k - i];
+        s += num / den;
+    }
+    return ((i + N / 2) % 2 == 0 ? 1.0 : -1.0) * s;
+}
+
+struct WeightTable {
+    double v[RowCount][MaxN]; // v[(N-MinN)/2][i-1] = V_i
+};
+
+constexpr WeightTable buildWeights()
+{
+    WeightTable t{};
+    for (int row = 0; row < RowCount; ++row) {
+        int N = MinN + 2 * row;
+        for (int i = 1; i <= N; ++i) t.v[row][i - 1] = coefficient(i, N);
+    }
+    return t;
+}
+
+constexpr WeightTable weights = buildWeights();
+
+// 编译期自检: 权重之和为 0，N=4 时 V = {-2, 26, -48, 24}
+static_assert(weights.v[0][0] == -2.0 && weights.v[0][1] == 26.0 &&
+              weights.v[0][2] == -48.0 && weights.v[0][3] == 24.0, "Stehfest N=4 weights");
+
+} // namespace StehfestDetail
+
+class StehfestTable
+{
+public:
+    static constexpr int MinN = StehfestDetail::MinN;
+    static constexpr int MaxN = StehfestDetail::MaxN;
+
+    // 将任意输入的 N 规范为表中存在的偶数阶 (非法值回退为 4，超过上限截断为 20)
+    static constexpr int normalizeN(int N)
+    {
+        if (N < MinN || N % 2 != 0) return MinN;
+        return (N > MaxN) ? MaxN : N;
+    }
+
+    // 权重 V_i (1 <= i <= N)，N 须已规范化
+    static constexpr double weight(int i, int N)
+    {
+        return StehfestDetail::weights.v[(N - MinN) / 2][i - 1];
+    }
+};
+
+// ============================================================================
+// LaplaceInversion: 数值反演方法接口
+// 所有方法的拉氏空间节点都与 1/t 成正比: s_j = u_j / tRef，u_j 为方法常数。
+// 因此无因次时间 tD = scale * t 变化时只需把节点整体除以 scale，
+// 节点常数与合成系数在构造时一次算好，之后的调用均为只读，可跨线程共享。
+// tRef 为参考时间: 除 de Hoog 外 tRef = t (每个时间点一组节点);
+// de Hoog 按时间量级 (十倍程) 分组，同组时间点共享一组节点。
+// ============================================================================
+class LaplaceInversion
+{
+public:
+    typedef std::complex<double> Complex;
+
+    enum Method {
+        Stehfest = 0,   // Gaver-Stehfest (实轴节点，阶数 N 为偶数 4~20，求值 N 次)
+        Euler,          // Euler 求和加速的 Fourier 级数 (Abate-Whitt)，求值 2M+1 次
+        FixedTalbot,    // 定步长 Talbot 围道 (Abate-Valko)，求值 M 次
+        DeHoog          // de Hoog 商差算法加速的 Fourier 级数，每个十倍程求值 2M+1 次
+    };
+
+    virtual ~LaplaceInversion() {}
+
+    virtual Method method() const = 0;
+    int order() const { return m_order; }
+
+    // 每组节点数 (即每组的拉氏空间求值次数)
+    int nodeCount() const { return m_nodes.size(); }
+    // 节点常数 u_j: s_j = u_j / tRef
+    const QVector<Complex>& unitNodes() const { return m_nodes; }
+    // 节点是否全部位于正实轴 (此时可直接使用实数形式的拉氏空间解)
+    virtual bool hasRealNodes() const { return false; }
+    // 是否按十倍程分组共享节点
+    virtual bool sharesNodesPerDecade() const { return false; }
+
+    // 由 F(s_j) (s_j = u_j / tRef) 合成 f(t)，errorEstimate 返回绝对误差估计 (可为 nullptr)
+    virtual double invert(double t, double tRef, const Complex* F, double* errorEstimate) const = 0;
+
+    // 工厂函数与方法信息
+    static QSharedPointer<const LaplaceInversion> create(Method method, int order);
+    static QString methodName(Method method);
+    static int methodCount() { return 4; }
+    // 将阶数规范到该方法的合法范围
+    static int normalizeOrder(Method method, int order);
+    // 高/低精度默认阶数 (低精度用于拟合迭代，高精度用于最终曲线与正演)
+    static int defaultOrder(Method method, bool highPrecision);
+
+protected:
+    explicit LaplaceInversion(int order) : m_order(order) {}
+
+    int m_order;
+    QVector<Complex> m_nodes;
+};
+
+// 一次反演的统计信息 (拉氏空间求值次数、估计误差)
+struct InversionStats {
+    int laplaceEvaluations;     // 拉氏空间解的求值次数
+    double maxRelativeError;    // 各时间点 误差估计/|pD| 的最大值
+    double interpolationError;  // 粗网格插值的估计相对误差 (未使用插值时为 0)
+
+    InversionStats() : laplaceEvaluations(0), maxRelativeError(0.0), interpolationError(0.0) {}
+
+    // 并入另一次计算的统计: 求值次数累加，误差取最大值
+    void merge(const InversionStats& other)
+    {
+        laplaceEvaluations += other.laplaceEvaluations;
+        maxRelativeError = std::max(maxRelativeError, other.maxRelativeError);
+        interpolationError = std::max(interpolationError, other.interpolationError);
+    }
+};
+
+// ============================================================================
+// InversionPlan: 固定时间网格上的反演计划
+// 持有反演方法实例，并把时间点划分为共享节点的组 (每组参考时间 tRef)。
+// 无因次时间 tD = scale * t 时，第 g 组的拉氏变量为 u_j / (scale * tRef_g)。
+// scale 随参数变化，因此同一计划可在整个拟合过程中复用。
+// ============================================================================
+class InversionPlan
+{
+public:
+    // 拉氏空间内裂缝影响系数自适应积分的默认容差
+    static constexpr double DefaultQuadratureTolerance = 1e-5;
+
+    InversionPlan();
+    InversionPlan(const QVector<double>& time, LaplaceInversion::Method method, int order,
+                  double quadratureTolerance = DefaultQuadratureTolerance);
+
+    bool isEmpty() const { return m_time.isEmpty(); }
+    const LaplaceInversion& inversion() const { return *m_inversion; }
+    LaplaceInversion::Method method() const { return m_inversion->method(); }
+    int order() const { return m_inversion->order(); }
+    int pointCount() const { return m_time.size(); }
+    const QVector<double>& time() const { return m_time; }
+    // 拉氏空间求值时自适应积分的容差 (与方法、阶数一起决定曲线精度)
+    double quadratureTolerance() const { return m_quadratureTolerance; }
+
+    // 计划是否适用于给定的时间网格、方法和阶数
+    bool matches(const QVector<double>& time, LaplaceInversion::Method method, int order) const;
+
+    // 节点分组: 第 g 组包含 groupPoint(i)，groupBegin(g) <= i < groupBegin(g+1)
+    // t <= 0 的时间点不属于任何组，反演结果直接置 0
+    int groupCount() const { return m_groupRefTime.size(); }
+    int groupBegin(int g) const { return m_groupOffset[g]; }
+    int groupEnd(int g) const { return m_groupOffset[g + 1]; }
+    int groupPoint(int i) const { return m_groupPoints[i]; }
+    double groupReferenceTime(int g) const { return m_groupRefTime[g]; }
+
+    // 完整计算一条曲线所需的拉氏空间求值次数
+    int laplaceEvaluationCount() const { return groupCount() * m_inversion->nodeCount(); }
+
+private:
+    QVector<double> m_time;
+    QSharedPointer<const LaplaceInversion> m_inversion;
+    double m_quadratureTolerance;
+    QVector<int> m_groupOffset;
+    QVector<int> m_groupPoints;
+    QVector<double> m_groupRefTime;
+};
+
+#endif // LAPLACEINVERSION_H
@@ -0,0 +1,54 @@
+/*
+ * latestvaluebuffer.h
+ * 文件作用：单写单读的 "最新值" 无锁缓冲区
+ * 功能描述：
+ * 1. 计算线程随时发布最新状态，界面线程按固定帧率轮询，只取最新一帧，中间帧直接被覆盖
+ * 2. 三槽交换 (写槽、待读槽、读槽)，发布与读取都只是一次原子交换，双方互不等待
+ * 3. 槽在交换中循环复用，写入方按元素覆盖已分配的容器，数据规模不变时不再分配内存
+ * 4. close() 之后读取方不再取出数据，用于计算结束后让位于最终结果的显示
+ */
+
+#ifndef LATESTVALUEBUFFER_H
+#define LATESTVALUEBUFFER_H
+
+#include <QAtomicInt>
+
+template <typename T>
+class LatestValueBuffer
+{
+public:
+    LatestValueBuffer() : m_write(0), m_read(2), m_pending(1), m_closed(0) {}
+
+    // 开始新一轮发布 (读取方调用，此时写入方尚未启动)：丢弃未读取的旧数据
+    void open()
+    {
+        m_pending.storeRelaxed(m_pending.loadRelaxed() & kIndexMask);
+        m_closed.storeRelease(0);
+    }
+
+    // 写入方: 填写 writeSlot() 后调用 publish() 发布；槽内保留的是三帧之前的数据
+    T& writeSlot() { return m_slots[m_write]; }
+    void publish() { m_write = m_pending.fetchAndStoreOrdered(m_write | kFresh) & kIndexMask; }
+    // 写入方: 不再发布，之后读取方的 take() 均返回 false
+    void close() { m_closed.storeRelease(1); }
+
+    // 读取方: 有未读取的新数据时交换到读槽并返回 true，数据由 readSlot() 访问
+    bool take()
+    {
+        if (m_closed.loadAcquire() || !(m_pending.loadAcquire() & kFresh)) return false;
+        m_read = m_pending.fetchAndStoreOrdered(m_read) & kIndexMask;
+        return true;
+    }
+    const T& readSlot() const { return m_slots[m_read]; }
+
+private:
+    enum { kIndexMask = 3, kFresh = 4 };
+
+    T m_slots[3];
+    int m_write;          // 写入方独占的槽
+    int m_read;           // 读取方独占的槽
+    QAtomicInt m_pending; // 待读取的槽，kFresh 位表示其中是尚未读取的新数据
+    QAtomicInt m_closed;
+};
+
+#endif // LATESTVALUEBUFFER_H
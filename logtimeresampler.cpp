@@ -0,0 +1,92 @@
+/*
+ * logtimeresampler.cpp
+ * 文件作用：观测数据的对数时间重采样实现
+ * 功能描述：
+ * 1. 区间编号 floor(log10(t)·pointsPerDecade)，输出按时间递增排列
+ * 2. 稳健均值: 以中位数为初值、MAD 为尺度的 Huber 迭代加权均值 (k = 1.345)
+ */
+
+#include "logtimeresampler.h"
+
+#include <QMap>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// 有效观测值的下限 (与拟合残差的有效性判断一致)
+const double kMinValue = 1e-10;
+
+double median(QVector<double> v)
+{
+    std::sort(v.begin(), v.end());
+    int n = v.size();
+    return (n % 2) ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+}
+}
+
+LogTimeResampler::Result LogTimeResampler::resample(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d,
+                                                    const Options& options)
+{
+    const int pointsPerDecade = qMax(1, options.pointsPerDecade);
+    QMap<int, QVector<int>> bins;
+    for (int i = 0; i < t.size(); ++i) {
+        if (t[i] <= 0.0) continue;
+        bins[(int)std::floor(std::log10(t[i]) * pointsPerDecade)].append(i);
+    }
+
+    Result result;
+    for (auto it = bins.cbegin(); it != bins.cend(); ++it) {
+        const QVector<int>& idx = it.value();
+        double logTime = 0.0;
+        QVector<double> pv, dv;
+        for (int i : idx) {
+            logTime += std::log(t[i]);
+            if (i < p.size() && p[i] > kMinValue) pv.append(p[i]);
+            if (i < d.size() && d[i] > kMinValue) dv.append(d[i]);
+        }
+        result.time.append(std::exp(logTime / idx.size()));
+        result.pressure.append(aggregate(pv, options.aggregation));
+        result.derivative.append(aggregate(dv, options.aggregation));
+        result.count.append(idx.size());
+    }
+    return result;
+}
+
+double LogTimeResampler::aggregate(QVector<double> values, Aggregation aggregation)
+{
+    if (values.isEmpty()) return 0.0;
+    if (values.size() == 1) return values[0];
+    if (aggregation == Median) return median(values);
+
+    // 在对数空间做 Huber M 估计: 偏离超过 k·scale 的点按 k·scale/|r| 降权
+    for (double& v : values) v = std::log(v);
+    double mu = median(values);
+    QVector<double> dev(values.size());
+    for (int i = 0; i < values.size(); ++i) dev[i] = std::abs(values[i] - mu);
+    double scale = 1.4826 * median(dev);
+    if (scale <= 0.0) return std::exp(mu);
+
+    const double k = 1.345 * scale;
+    for (int iter = 0; iter < 20; ++iter) {
+        double sw = 0.0, swx = 0.0;
+        for (double x : values) {
+            double r = std::abs(x - mu);
+            double w = r <= k ? 1.0 : k / r;
+            sw += w; swx += w * x;
+        }
+        double next = swx / sw;
+        bool done = std::abs(next - mu) < 1e-10 * scale;
+        mu = next;
+        if (done) break;
+    }
+    return std::exp(mu);
+}
+
+QString LogTimeResampler::aggregationName(Aggregation aggregation)
+{
+    switch (aggregation) {
+    case Median: return "中位数";
+    case RobustMean: return "稳健均值";
+    default: return QString();
+    }
+}
@@ -0,0 +1,48 @@
+/*
+ * logtimeresampler.h
+ * 文件作用：观测数据的对数时间重采样头文件
+ * 功能描述：
+ * 1. 按每十倍时间 pointsPerDecade 个对数等宽区间聚合观测压力与导数，长时间高频采样的记录也只保留几百个代表点
+ * 2. 区间内按中位数或稳健均值 (Huber M 估计，在对数空间计算) 聚合，抑制个别跳点的影响
+ * 3. 保留每个代表点对应的原始点数，供拟合按点数加权
+ */
+
+#ifndef LOGTIMERESAMPLER_H
+#define LOGTIMERESAMPLER_H
+
+#include <QVector>
+#include <QString>
+
+class LogTimeResampler
+{
+public:
+    // 区间内的聚合方式
+    enum Aggregation { Median, RobustMean, AggregationCount };
+
+    struct Options {
+        bool enabled;
+        int pointsPerDecade;     // 每十倍时间的区间数
+        Aggregation aggregation;
+
+        Options() : enabled(false), pointsPerDecade(20), aggregation(Median) {}
+    };
+
+    // 重采样结果: 各区间的代表时间 (对数平均)、压力与导数 (无有效值时为 0)，以及区间内的原始点数
+    struct Result {
+        QVector<double> time;
+        QVector<double> pressure;
+        QVector<double> derivative;
+        QVector<double> count;
+    };
+
+    // 时间不大于 0 的点无法放到对数轴上，直接舍弃；只有一个点的区间原样保留
+    static Result resample(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d, const Options& options);
+
+    static QString aggregationName(Aggregation aggregation);
+
+private:
+    // 正值的聚合 (values 中不大于 0 的无效值已剔除)，values 为空时返回 0
+    static double aggregate(QVector<double> values, Aggregation aggregation);
+};
+
+#endif // LOGTIMERESAMPLER_H
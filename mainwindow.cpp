@@ -209,6 +209,7 @@ void MainWindow::onProjectCreated()
     if (m_ModelManager) {
         m_ModelManager->updateAllModelsBasicParameters();
     }
+    updateCurveCacheLocation();
 
     // 2. 刷新拟合界面状态
     if (m_FittingPage) {
@@ -235,6 +236,9 @@ void MainWindow::onProjectClosed()
     m_isProjectLoaded = false;
     m_hasValidData = false;
 
+    // 0. 理论曲线缓存写回原项目文件夹
+    updateCurveCacheLocation();
+
     // 1. 清空数据编辑器
     if (m_DataEditorWidget) {
         // m_DataEditorWidget->clear();
@@ -387,6 +391,15 @@ void MainWindow::onFittingProgressChanged(int progress)
 void MainWindow::onSystemSettingsChanged()
 {
     qDebug() << "系统设置已变更";
+    updateCurveCacheLocation();
+}
+
+void MainWindow::updateCurveCacheLocation()
+{
+    if (!m_ModelManager) return;
+    bool persist = m_SettingsWidget && m_SettingsWidget->isCurveCachePersistent();
+    QString dir = (m_isProjectLoaded && persist) ? ModelParameter::instance()->getProjectPath() : QString();
+    m_ModelManager->setCurveCacheDirectory(dir);
 }
 
 void MainWindow::onPerformanceSettingsChanged() {}
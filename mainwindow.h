@@ -107,6 +107,8 @@ private:
     void updateNavigationState();
     // 将数据传输至拟合模块
     void transferDataToFitting();
+    // 根据系统设置把理论曲线缓存关联到当前项目文件夹 (未打开项目或未启用持久化时只在内存中缓存)
+    void updateCurveCacheLocation();
 
     // 获取数据编辑器的数据模型
     QStandardItemModel* getDataEditorModel() const;
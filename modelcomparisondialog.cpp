@@ -0,0 +1,188 @@
+/*
+ * modelcomparisondialog.cpp
+ * 文件作用：多模型自动拟合结果对比对话框的具体实现
+ * 功能描述：
+ * 1. 计算各模型的 AICc、BIC 与 Akaike 权重，按 AICc 排名显示在表格中
+ * 2. 双对数图叠加实测数据与各模型的理论曲线，选中行的模型加粗高亮
+ * 3. 记录用户采用的模型，供拟合界面切换模型并载入拟合参数
+ */
+
+#include "modelcomparisondialog.h"
+#include "ui_modelcomparisondialog.h"
+#include <QHeaderView>
+#include <QTableWidgetItem>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+double ModelComparisonEntry::aicc() const
+{
+    int n = residualCount, k = parameterCount;
+    if(n <= k + 1) return std::numeric_limits<double>::infinity();
+    double aic = n * std::log(qMax(sse, 1e-300) / n) + 2.0 * k;
+    return aic + 2.0 * k * (k + 1) / double(n - k - 1);
+}
+
+double ModelComparisonEntry::bic() const
+{
+    int n = residualCount, k = parameterCount;
+    if(n <= 0) return std::numeric_limits<double>::infinity();
+    return n * std::log(qMax(sse, 1e-300) / n) + k * std::log(double(n));
+}
+
+ModelComparisonDialog::ModelComparisonDialog(const QVector<ModelComparisonEntry>& entries, const QVector<double>& obsTime,
+                                             const QVector<double>& obsPressure, const QVector<double>& obsDerivative, QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::ModelComparisonDialog),
+    m_entries(entries)
+{
+    ui->setupUi(this);
+    this->setWindowTitle("多模型拟合对比");
+
+    std::stable_sort(m_entries.begin(), m_entries.end(), [](const ModelComparisonEntry& a, const ModelComparisonEntry& b) {
+        double ca = a.aicc(), cb = b.aicc();
+        if(ca != cb) return ca < cb;
+        return a.mse() < b.mse();
+    });
+
+    m_plot = new MouseZoom(this);
+    ui->plotContainer->layout()->addWidget(m_plot);
+
+    connect(ui->btnAdopt, &QPushButton::clicked, this, &ModelComparisonDialog::onAdopt);
+    connect(ui->btnClose, &QPushButton::clicked, this, &ModelComparisonDialog::reject);
+    ui->btnClose->setAutoDefault(false);
+
+    initPlot(obsTime, obsPressure, obsDerivative);
+    initTable();
+    connect(ui->tableWidget, &QTableWidget::itemSelectionChanged, this, &ModelComparisonDialog::onSelectionChanged);
+    if(!m_entries.isEmpty()) ui->tableWidget->selectRow(0);
+}
+
+ModelComparisonDialog::~ModelComparisonDialog()
+{
+    delete ui;
+}
+
+void ModelComparisonDialog::initTable()
+{
+    QStringList headers;
+    headers << "排名" << "模型" << "拟合参数数" << "MSE" << "AICc" << "ΔAICc" << "Akaike 权重" << "BIC" << "状态";
+    ui->tableWidget->setColumnCount(headers.size());
+    ui->tableWidget->setHorizontalHeaderLabels(headers);
+    ui->tableWidget->setRowCount(m_entries.size());
+    ui->tableWidget->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    ui->tableWidget->setSelectionBehavior(QAbstractItemView::SelectRows);
+    ui->tableWidget->setSelectionMode(QAbstractItemView::SingleSelection);
+    ui->tableWidget->verticalHeader()->setVisible(false);
+
+    // Akaike 权重: exp(-ΔAICc/2) 归一化，表示各模型在候选集中为最优模型的相对可能性
+    double bestAicc = m_entries.isEmpty() ? 0.0 : m_entries.first().aicc();
+    double weightSum = 0.0;
+    for(const auto& e : m_entries) {
+        if(std::isfinite(e.aicc())) weightSum += std::exp(-0.5 * (e.aicc() - bestAicc));
+    }
+
+    for(int i = 0; i < m_entries.size(); ++i) {
+        const ModelComparisonEntry& e = m_entries[i];
+        double aicc = e.aicc();
+        bool finite = std::isfinite(aicc) && std::isfinite(bestAicc);
+        double weight = (finite && weightSum > 0.0) ? std::exp(-0.5 * (aicc - bestAicc)) / weightSum : 0.0;
+        QColor color = m_graphs.value(i).first ? m_graphs[i].first->pen().color() : QColor(Qt::black);
+
+        QStringList cells;
+        cells << QString::number(i + 1)
+              << ModelManager::getModelTypeName(e.modelType)
+              << QString::number(e.parameterCount)
+              << QString::number(e.mse(), 'e', 3)
+              << (finite ? QString::number(aicc, 'f', 2) : "-")
+              << (finite ? QString::number(aicc - bestAicc, 'f', 2) : "-")
+              << QString::number(weight, 'f', 3)
+              << (std::isfinite(e.bic()) ? QString::number(e.bic(), 'f', 2) : "-")
+              << (e.eliminatedRound > 0 ? QString("第 %1 轮提前淘汰").arg(e.eliminatedRound) : "完成精修");
+        for(int c = 0; c < cells.size(); ++c) {
+            QTableWidgetItem* item = new QTableWidgetItem(cells[c]);
+            item->setTextAlignment(c == 1 ? (Qt::AlignLeft | Qt::AlignVCenter) : Qt::Alignment(Qt::AlignCenter));
+            if(c == 1) item->setForeground(color);
+            ui->tableWidget->setItem(i, c, item);
+        }
+    }
+
+    ui->tableWidget->resizeColumnsToContents();
+    ui->tableWidget->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Stretch);
+}
+
+void ModelComparisonDialog::initPlot(const QVector<double>& obsTime, const QVector<double>& obsPressure, const QVector<double>& obsDerivative)
+{
+    QSharedPointer<QCPAxisTickerLog> logTicker(new QCPAxisTickerLog);
+    m_plot->xAxis->setScaleType(QCPAxis::stLogarithmic); m_plot->xAxis->setTicker(logTicker);
+    m_plot->yAxis->setScaleType(QCPAxis::stLogarithmic); m_plot->yAxis->setTicker(logTicker);
+    m_plot->xAxis->setNumberFormat("eb"); m_plot->xAxis->setNumberPrecision(0);
+    m_plot->yAxis->setNumberFormat("eb"); m_plot->yAxis->setNumberPrecision(0);
+    m_plot->xAxis->setLabel("时间 Time (h)"); m_plot->yAxis->setLabel("压力 & 导数 Pressure & Derivative (MPa)");
+    m_plot->xAxis->grid()->setSubGridVisible(true); m_plot->yAxis->grid()->setSubGridVisible(true);
+    m_plot->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom);
+
+    // 实测数据 (去掉非正值，与拟合界面一致)
+    QVector<double> vt, vp, vdt, vd;
+    for(int i = 0; i < obsTime.size(); ++i) {
+        if(obsTime[i] <= 1e-6) continue;
+        if(i < obsPressure.size() && obsPressure[i] > 1e-6) { vt << obsTime[i]; vp << obsPressure[i]; }
+        if(i < obsDerivative.size() && obsDerivative[i] > 1e-6) { vdt << obsTime[i]; vd << obsDerivative[i]; }
+    }
+    QCPGraph* gp = m_plot->addGraph(); gp->setPen(Qt::NoPen); gp->setName("实测压力");
+    gp->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssCircle, QColor(0, 100, 0), 5));
+    gp->setData(vt, vp);
+    QCPGraph* gd = m_plot->addGraph(); gd->setPen(Qt::NoPen); gd->setName("实测导数");
+    gd->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssTriangle, Qt::magenta, 5));
+    gd->setData(vdt, vd);
+
+    // 各模型: 压力实线、导数虚线，同一模型同色
+    const QList<QColor> palette = { QColor(220, 20, 60), QColor(30, 144, 255), QColor(255, 140, 0),
+                                    QColor(138, 43, 226), QColor(0, 139, 139), QColor(139, 69, 19) };
+    for(int i = 0; i < m_entries.size(); ++i) {
+        const ModelComparisonEntry& e = m_entries[i];
+        QColor color = palette[i % palette.size()];
+        QVector<double> mt, mp, mdt, md;
+        for(int j = 0; j < e.t.size(); ++j) {
+            if(e.t[j] <= 1e-8) continue;
+            if(j < e.p.size() && e.p[j] > 1e-8) { mt << e.t[j]; mp << e.p[j]; }
+            if(j < e.d.size() && e.d[j] > 1e-8) { mdt << e.t[j]; md << e.d[j]; }
+        }
+        QCPGraph* pg = m_plot->addGraph(); pg->setPen(QPen(color, 1.5)); pg->setData(mt, mp);
+        pg->setName(QString("#%1 模型%2").arg(i + 1).arg((int)e.modelType + 1));
+        QCPGraph* dg = m_plot->addGraph(); dg->setPen(QPen(color, 1.5, Qt::DashLine)); dg->setData(mdt, md);
+        dg->removeFromLegend();
+        m_graphs.append(qMakePair(pg, dg));
+    }
+
+    m_plot->legend->setVisible(true); m_plot->legend->setFont(QFont("Arial", 9));
+    m_plot->legend->setBrush(QBrush(QColor(255, 255, 255, 200)));
+    m_plot->rescaleAxes();
+    if(m_plot->xAxis->range().lower <= 0) m_plot->xAxis->setRangeLower(1e-3);
+    if(m_plot->yAxis->range().lower <= 0) m_plot->yAxis->setRangeLower(1e-3);
+    m_plot->replot();
+}
+
+int ModelComparisonDialog::selectedIndex() const
+{
+    QList<QTableWidgetItem*> items = ui->tableWidget->selectedItems();
+    return items.isEmpty() ? -1 : items.first()->row();
+}
+
+void ModelComparisonDialog::onSelectionChanged()
+{
+    int selected = selectedIndex();
+    for(int i = 0; i < m_graphs.size(); ++i) {
+        double width = (i == selected) ? 3.0 : 1.0;
+        QPen pp = m_graphs[i].first->pen(); pp.setWidthF(width); m_graphs[i].first->setPen(pp);
+        QPen dp = m_graphs[i].second->pen(); dp.setWidthF(width); m_graphs[i].second->setPen(dp);
+    }
+    ui->btnAdopt->setEnabled(selected >= 0);
+    m_plot->replot();
+}
+
+void ModelComparisonDialog::onAdopt()
+{
+    if(selectedIndex() < 0) return;
+    accept();
+}
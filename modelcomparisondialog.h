@@ -0,0 +1,74 @@
+#ifndef MODELCOMPARISONDIALOG_H
+#define MODELCOMPARISONDIALOG_H
+
+#include <QDialog>
+#include <QVector>
+#include "fittingparameterchart.h"
+#include "mousezoom.h"
+
+namespace Ui {
+class ModelComparisonDialog;
+}
+
+// 多模型对比中单个模型的拟合结果 (残差均在完整精度的最终曲线上计算，各模型可直接比较)
+struct ModelComparisonEntry {
+    ModelManager::ModelType modelType;
+    QList<FitParameter> params; // 拟合后的参数表
+    int parameterCount;         // 参与拟合的参数个数 k
+    int residualCount;          // 残差个数 n
+    double sse;                 // 残差平方和
+    int eliminatedRound;        // 被提前淘汰的轮次 (从 1 计)，0 表示完成了完整精度的精修
+    QVector<double> t, p, d;    // 拟合时间 (重采样代表点) 上的理论压力与导数
+
+    ModelComparisonEntry() : modelType(ModelManager::Model_1), parameterCount(0), residualCount(0), sse(0.0), eliminatedRound(0) {}
+
+    double mse() const { return residualCount > 0 ? sse / residualCount : sse; }
+    // 小样本修正的 Akaike 信息准则: n·ln(SSE/n) + 2k + 2k(k+1)/(n-k-1)；n <= k+1 时为无穷大
+    double aicc() const;
+    // 贝叶斯信息准则: n·ln(SSE/n) + k·ln(n)
+    double bic() const;
+};
+
+// ===========================================================================
+// 类名：ModelComparisonDialog
+// 作用：多模型自动拟合结果对比弹窗
+// 功能：
+// 1. 按 AICc 排序列出各模型的拟合参数数、MSE、AICc、ΔAICc、Akaike 权重与 BIC
+// 2. 在同一双对数图上叠加实测数据与各模型的理论压力、导数曲线，选中行的模型加粗显示
+// 3. "采用所选模型" 后由调用方切换到该模型并载入其拟合参数
+// ===========================================================================
+
+class ModelComparisonDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit ModelComparisonDialog(const QVector<ModelComparisonEntry>& entries, const QVector<double>& obsTime,
+                                   const QVector<double>& obsPressure, const QVector<double>& obsDerivative, QWidget *parent = nullptr);
+    ~ModelComparisonDialog();
+
+    // 用户采用的模型结果 (按排名后的顺序)，未选择时返回 -1
+    int selectedIndex() const;
+    const QVector<ModelComparisonEntry>& entries() const { return m_entries; }
+
+private:
+    Ui::ModelComparisonDialog *ui;
+    MouseZoom* m_plot;
+
+    // 按 AICc 排序后的结果 (AICc 相同或无穷大时按 MSE)
+    QVector<ModelComparisonEntry> m_entries;
+    // 各模型的理论压力、导数曲线 (与 m_entries 同序)
+    QVector<QPair<QCPGraph*, QCPGraph*>> m_graphs;
+
+    // 初始化表格视图
+    void initTable();
+    // 初始化叠加对比图
+    void initPlot(const QVector<double>& obsTime, const QVector<double>& obsPressure, const QVector<double>& obsDerivative);
+
+private slots:
+    // 选中行改变时加粗对应模型的曲线
+    void onSelectionChanged();
+    void onAdopt();
+};
+
+#endif // MODELCOMPARISONDIALOG_H
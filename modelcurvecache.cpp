@@ -0,0 +1,153 @@
+/*
+ * modelcurvecache.cpp
+ * 文件作用：理论曲线结果缓存实现
+ * 功能描述：
+ * 1. 缓存键 = 模型/反演头部 + SHA-1(已设置参数的下标与数值) + SHA-1(时间网格)
+ * 2. QCache 负责 LRU 淘汰，所有访问由互斥锁保护
+ * 3. 缓存文件格式: 魔数 + 版本 + 条目数 + 逐条 (键, 时间, 压力, 导数, 反演误差, 插值误差)
+ */
+
+#include "modelcurvecache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QFile>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+const quint32 kFileMagic = 0x57544343; // "WTCC"
+// 文件格式版本；求解器数值结果发生变化时一并递增，使旧缓存失效
+const quint32 kFileVersion = 6;
+
+// 按二进制位写入 double，-0 归一为 +0，保证相等的参数产生相同的键
+void addDouble(QCryptographicHash& hash, double v)
+{
+    if (v == 0.0) v = 0.0;
+    quint64 bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    hash.addData(QByteArray(reinterpret_cast<const char*>(&bits), sizeof(bits)));
+}
+}
+
+ModelCurveCache::ModelCurveCache(int maxPoints)
+    : m_cache(maxPoints)
+{
+}
+
+QByteArray ModelCurveCache::makeKey(int modelType, const ModelParams& params, const QVector<double>& time,
+                                    LaplaceInversion::Method method, int order, double quadratureTolerance,
+                                    const CompositeModelSolver::CoarseGridOptions& grid)
+{
+    QByteArray key;
+    QDataStream header(&key, QIODevice::WriteOnly);
+    header << kFileVersion << qint32(modelType) << qint32(method) << qint32(order) << quadratureTolerance << qint32(time.size());
+    // 粗网格选项只在实际生效时参与键 (逐点计算的结果与这些选项无关)
+    if (grid.appliesTo(time.isEmpty() ? 100 : time.size())) {
+        header << qint32(grid.pointsPerDecade) << grid.tolerance << qint32(grid.maxRefineLevels);
+    }
+
+    QCryptographicHash paramHash(QCryptographicHash::Sha1);
+    for (int i = 0; i < ModelParams::Count; ++i) {
+        ModelParams::Id id = ModelParams::Id(i);
+        if (!params.contains(id)) continue;
+        paramHash.addData(QByteArray(1, char(i)));
+        addDouble(paramHash, params[id]);
+    }
+
+    QCryptographicHash timeHash(QCryptographicHash::Sha1);
+    for (double t : time) addDouble(timeHash, t);
+
+    key.append(paramHash.result());
+    key.append(timeHash.result());
+    return key;
+}
+
+bool ModelCurveCache::find(const QByteArray& key, ModelCurveData& curve, InversionStats* stats)
+{
+    QMutexLocker locker(&m_mutex);
+    Entry* entry = m_cache.object(key);
+    if (!entry) return false;
+    curve = entry->curve;
+    if (stats) {
+        stats->maxRelativeError = std::max(stats->maxRelativeError, entry->maxRelativeError);
+        stats->interpolationError = std::max(stats->interpolationError, entry->interpolationError);
+    }
+    return true;
+}
+
+void ModelCurveCache::insert(const QByteArray& key, const ModelCurveData& curve, const InversionStats& curveStats)
+{
+    int cost = std::get<0>(curve).size();
+    if (cost <= 0) return;
+
+    Entry* entry = new Entry;
+    entry->curve = curve;
+    entry->maxRelativeError = curveStats.maxRelativeError;
+    entry->interpolationError = curveStats.interpolationError;
+
+    QMutexLocker locker(&m_mutex);
+    m_cache.insert(key, entry, cost); // 超出容量时 QCache 负责删除 entry
+}
+
+void ModelCurveCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.clear();
+}
+
+int ModelCurveCache::count() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.count();
+}
+
+bool ModelCurveCache::load(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    quint32 magic = 0, version = 0;
+    qint32 entryCount = 0;
+    in >> magic >> version >> entryCount;
+    if (in.status() != QDataStream::Ok || magic != kFileMagic || version != kFileVersion || entryCount < 0) return false;
+
+    QMutexLocker locker(&m_mutex);
+    for (int i = 0; i < entryCount; ++i) {
+        QByteArray key;
+        QVector<double> t, p, d;
+        double err = 0.0, interpErr = 0.0;
+        in >> key >> t >> p >> d >> err >> interpErr;
+        if (in.status() != QDataStream::Ok) return false;
+        if (t.isEmpty() || p.size() != t.size() || d.size() != t.size()) continue;
+
+        Entry* entry = new Entry;
+        entry->curve = std::make_tuple(t, p, d);
+        entry->maxRelativeError = err;
+        entry->interpolationError = interpErr;
+        m_cache.insert(key, entry, t.size());
+    }
+    return true;
+}
+
+bool ModelCurveCache::save(const QString& filePath) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    // 写入临时文件后再替换，避免中途失败留下损坏的缓存文件
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    const QList<QByteArray> keys = m_cache.keys();
+    QDataStream out(&file);
+    out << kFileMagic << kFileVersion << qint32(keys.size());
+    for (const QByteArray& key : keys) {
+        const Entry* entry = m_cache.object(key);
+        out << key << std::get<0>(entry->curve) << std::get<1>(entry->curve) << std::get<2>(entry->curve)
+            << entry->maxRelativeError << entry->interpolationError;
+    }
+    return file.commit();
+}
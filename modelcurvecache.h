@@ -0,0 +1,59 @@
+/*
+ * modelcurvecache.h
+ * 文件作用：理论曲线结果缓存头文件
+ * 功能描述：
+ * 1. 以 (模型类型, 反演方法与阶数, 粗网格选项, 参数规范哈希, 时间网格指纹) 为键缓存整条理论曲线
+ * 2. 基于 QCache 的有界 LRU 策略，容量按缓存的时间点总数计算，超出时淘汰最久未使用的曲线
+ * 3. 内部加锁，可被拟合线程与界面线程同时访问
+ * 4. 可选持久化: 以二进制文件保存到项目文件夹，重新打开项目后相同的计算直接命中
+ */
+
+#ifndef MODELCURVECACHE_H
+#define MODELCURVECACHE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include "compositemodelsolver.h"
+
+class ModelCurveCache
+{
+public:
+    // maxPoints: 缓存中所有曲线的时间点总数上限
+    explicit ModelCurveCache(int maxPoints = 200000);
+
+    // 构造缓存键。参数按下标顺序、数值按二进制位参与哈希 (-0 归一为 +0)；
+    // 时间网格为空时表示求解器默认网格
+    static QByteArray makeKey(int modelType, const ModelParams& params, const QVector<double>& time,
+                              LaplaceInversion::Method method, int order, double quadratureTolerance,
+                              const CompositeModelSolver::CoarseGridOptions& grid = CompositeModelSolver::CoarseGridOptions());
+
+    // 查找曲线；命中时把该曲线的估计反演误差与插值误差并入 stats (不增加求值次数)
+    bool find(const QByteArray& key, ModelCurveData& curve, InversionStats* stats = nullptr);
+    // 插入曲线，curveStats 为计算该曲线时的统计 (只保存误差估计)
+    void insert(const QByteArray& key, const ModelCurveData& curve, const InversionStats& curveStats);
+    void clear();
+
+    int count() const;
+
+    // 持久化 (QDataStream 二进制格式，版本不符或文件损坏时忽略)
+    bool load(const QString& filePath);
+    bool save(const QString& filePath) const;
+
+    // 项目文件夹中的缓存文件名
+    static QString defaultFileName() { return "curvecache.dat"; }
+
+private:
+    struct Entry {
+        ModelCurveData curve;
+        double maxRelativeError;
+        double interpolationError;
+    };
+
+    mutable QMutex m_mutex;
+    QCache<QByteArray, Entry> m_cache;
+};
+
+#endif // MODELCURVECACHE_H
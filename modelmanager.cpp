@@ -17,15 +17,24 @@
 #include <QLabel>
 #include <QGroupBox>
 #include <QDebug>
+#include <QDir>
 #include <cmath>
+#include <algorithm>
 
 ModelManager::ModelManager(QWidget* parent)
     : QObject(parent), m_mainWidget(nullptr), m_btnSelectModel(nullptr), m_modelStack(nullptr)
     , m_currentModelType(Model_1)
 {
+    // 求解器与界面无关，构造时即可创建，保证未初始化界面时也能计算
+    for (int i = Model_1; i <= Model_6; ++i) {
+        m_solvers.append(CompositeModelSolver((ModelType)i));
+    }
 }
 
-ModelManager::~ModelManager() {}
+ModelManager::~ModelManager()
+{
+    setCurveCacheDirectory(QString());
+}
 
 void ModelManager::initializeModels(QWidget* parentWidget)
 {
@@ -164,12 +173,6 @@ void ModelManager::onWidgetCalculationCompleted(const QString &t, const QMap<QSt
     emit calculationCompleted(t, r);
 }
 
-void ModelManager::setHighPrecision(bool high) {
-    for(ModelWidget01_06* w : m_modelWidgets) {
-        w->setHighPrecision(high);
-    }
-}
-
 void ModelManager::updateAllModelsBasicParameters()
 {
     for(ModelWidget01_06* w : m_modelWidgets) {
@@ -178,66 +181,117 @@ void ModelManager::updateAllModelsBasicParameters()
     qDebug() << "所有模型的参数已从全局项目设置中刷新。";
 }
 
-QMap<QString, double> ModelManager::getDefaultParameters(ModelType type)
+ModelParams ModelManager::getDefaultParameters(ModelType type)
 {
-    QMap<QString, double> p;
+    ModelParams p;
     ModelParameter* mp = ModelParameter::instance();
 
     // 基础参数 (从项目文件读取)
-    p.insert("phi", mp->getPhi());
-    p.insert("h", mp->getH());
-    p.insert("mu", mp->getMu());
-    p.insert("B", mp->getB());
-    p.insert("Ct", mp->getCt());
-    p.insert("q", mp->getQ());
+    p.set(ModelParams::Phi, mp->getPhi());
+    p.set(ModelParams::H, mp->getH());
+    p.set(ModelParams::Mu, mp->getMu());
+    p.set(ModelParams::B, mp->getB());
+    p.set(ModelParams::Ct, mp->getCt());
+    p.set(ModelParams::Q, mp->getQ());
 
     // 默认模型特定参数
-    p.insert("nf", 4.0);
-    p.insert("kf", 1e-3);
-    p.insert("km", 1e-4);
-    p.insert("L", 1000.0);
-    p.insert("Lf", 100.0);
-    p.insert("LfD", 0.1);
-    p.insert("rmD", 4.0);
-    p.insert("omega1", 0.4);
-    p.insert("omega2", 0.08);
-    p.insert("lambda1", 1e-3);
-    p.insert("gamaD", 0.02);
+    p.set(ModelParams::Nf, 4.0);
+    p.set(ModelParams::Kf, 1e-3);
+    p.set(ModelParams::Km, 1e-4);
+    p.set(ModelParams::L, 1000.0);
+    p.set(ModelParams::Lf, 100.0);
+    p.set(ModelParams::LfD, 0.1);
+    p.set(ModelParams::RmD, 4.0);
+    p.set(ModelParams::Omega1, 0.4);
+    p.set(ModelParams::Omega2, 0.08);
+    p.set(ModelParams::Lambda1, 1e-3);
+    p.set(ModelParams::GamaD, 0.02);
 
     // 变井储模型 (1, 3, 5)
-    if (type == Model_1 || type == Model_3 || type == Model_5) {
-        p.insert("cD", 0.01);
-        p.insert("S", 1.0);
+    if (CompositeModelSolver::hasWellboreStorage(type)) {
+        p.set(ModelParams::CD, 0.01);
+        p.set(ModelParams::S, 1.0);
     } else {
-        p.insert("cD", 0.0);
-        p.insert("S", 0.0);
+        p.set(ModelParams::CD, 0.0);
+        p.set(ModelParams::S, 0.0);
     }
 
     // 封闭或定压边界模型 (3, 4, 5, 6) 需要 reD
-    if (type == Model_3 || type == Model_4 || type == Model_5 || type == Model_6) {
-        p.insert("reD", 10.0);
+    if (CompositeModelSolver::hasOuterBoundary(type)) {
+        p.set(ModelParams::ReD, 10.0);
     }
 
     return p;
 }
 
-ModelCurveData ModelManager::calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime)
+ModelCurveData ModelManager::calculateTheoreticalCurve(ModelType type, const ModelParams& params, const QVector<double>& providedTime,
+                                                       const SolverOptions& options, InversionStats* stats) const
 {
     int index = (int)type;
-    if (index >= 0 && index < m_modelWidgets.size()) {
-        return m_modelWidgets[index]->calculateTheoreticalCurve(params, providedTime);
+    if (index < 0 || index >= m_solvers.size()) return ModelCurveData();
+
+    QByteArray key = ModelCurveCache::makeKey(index, params, providedTime, options.inversionMethod, options.inversionOrder,
+                                              options.quadratureTolerance, options.coarseGrid);
+    ModelCurveData curve;
+    if (m_curveCache.find(key, curve, stats)) return curve;
+
+    InversionStats curveStats;
+    curve = m_solvers[index].calculateTheoreticalCurve(params, providedTime, options, &curveStats);
+    // 被取消的计算结果不完整，不进入缓存
+    if (!options.parallel.cancellation.isCancelled()) m_curveCache.insert(key, curve, curveStats);
+    if (stats) stats->merge(curveStats);
+    return curve;
+}
+
+ModelCurveData ModelManager::calculateTheoreticalCurve(ModelType type, const ModelParams& params, const InversionPlan& plan,
+                                                       InversionStats* stats, const ParallelOptions& parallel) const
+{
+    int index = (int)type;
+    if (index < 0 || index >= m_solvers.size() || plan.isEmpty()) return ModelCurveData();
+
+    QByteArray key = ModelCurveCache::makeKey(index, params, plan.time(), plan.method(), plan.order(), plan.quadratureTolerance());
+    ModelCurveData curve;
+    if (m_curveCache.find(key, curve, stats)) return curve;
+
+    InversionStats curveStats;
+    curve = m_solvers[index].calculateTheoreticalCurve(params, plan, &curveStats, parallel);
+    if (!parallel.cancellation.isCancelled()) m_curveCache.insert(key, curve, curveStats);
+    if (stats) stats->merge(curveStats);
+    return curve;
+}
+
+ModelManager::CurveSensitivity ModelManager::calculateSensitivity(ModelType type, const ModelParams& params, const InversionPlan& plan,
+                                                                  const QVector<Sensitivity>& directions, InversionStats* stats,
+                                                                  const ParallelOptions& parallel) const
+{
+    int index = (int)type;
+    if (index < 0 || index >= m_solvers.size() || plan.isEmpty()) return CurveSensitivity();
+    return m_solvers[index].calculateSensitivity(params, plan, directions, stats, parallel);
+}
+
+void ModelManager::setCurveCacheDirectory(const QString& dirPath)
+{
+    if (dirPath == m_curveCacheDir) return;
+
+    // 先把当前缓存写回原项目文件夹，再加载新项目的缓存 (内存中的曲线仍然有效，予以保留)
+    if (!m_curveCacheDir.isEmpty() && QDir(m_curveCacheDir).exists()) {
+        QString file = QDir(m_curveCacheDir).filePath(ModelCurveCache::defaultFileName());
+        if (!m_curveCache.save(file)) qDebug() << "理论曲线缓存保存失败:" << file;
+    }
+    m_curveCacheDir = dirPath;
+    if (!m_curveCacheDir.isEmpty()) {
+        m_curveCache.load(QDir(m_curveCacheDir).filePath(ModelCurveCache::defaultFileName()));
+        qDebug() << "理论曲线缓存已加载, 条目数:" << m_curveCache.count();
     }
-    return ModelCurveData();
+}
+
+void ModelManager::clearCurveCache()
+{
+    m_curveCache.clear();
 }
 
 QVector<double> ModelManager::generateLogTimeSteps(int count, double startExp, double endExp) {
-    QVector<double> t;
-    t.reserve(count);
-    for (int i = 0; i < count; ++i) {
-        double exponent = startExp + (endExp - startExp) * i / (count - 1);
-        t.append(pow(10.0, exponent));
-    }
-    return t;
+    return CompositeModelSolver::generateLogTimeSteps(count, startExp, endExp);
 }
 
 void ModelManager::setObservedData(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d)
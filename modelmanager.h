@@ -7,22 +7,28 @@
 #include <QStackedWidget>
 #include <QPushButton>
 
-// 引入合并后的 ModelWidget 头文件
+// 引入合并后的 ModelWidget 头文件 (同时引入无界面求解器 CompositeModelSolver)
 #include "modelwidget01-06.h"
+#include "modelcurvecache.h"
 
 class ModelManager : public QObject
 {
     Q_OBJECT
 
 public:
-    // 使用 ModelWidget01_06 中定义的枚举
-    using ModelType = ModelWidget01_06::ModelType;
-    static const ModelType Model_1 = ModelWidget01_06::Model_1;
-    static const ModelType Model_2 = ModelWidget01_06::Model_2;
-    static const ModelType Model_3 = ModelWidget01_06::Model_3;
-    static const ModelType Model_4 = ModelWidget01_06::Model_4;
-    static const ModelType Model_5 = ModelWidget01_06::Model_5;
-    static const ModelType Model_6 = ModelWidget01_06::Model_6;
+    // 使用 CompositeModelSolver 中定义的枚举
+    using ModelType = CompositeModelSolver::ModelType;
+    using SolverOptions = CompositeModelSolver::SolverOptions;
+    using ParallelOptions = CompositeModelSolver::ParallelOptions;
+    using Sensitivity = CompositeModelSolver::Sensitivity;
+    using CurveSensitivity = CompositeModelSolver::CurveSensitivity;
+    // 参数以定长索引的 ModelParams 传递，具名参数表只在界面与项目文件处转换
+    static const ModelType Model_1 = CompositeModelSolver::Model_1;
+    static const ModelType Model_2 = CompositeModelSolver::Model_2;
+    static const ModelType Model_3 = CompositeModelSolver::Model_3;
+    static const ModelType Model_4 = CompositeModelSolver::Model_4;
+    static const ModelType Model_5 = CompositeModelSolver::Model_5;
+    static const ModelType Model_6 = CompositeModelSolver::Model_6;
 
     explicit ModelManager(QWidget* parent = nullptr);
     ~ModelManager();
@@ -37,13 +43,34 @@ public:
     static QString getModelTypeName(ModelType type);
 
     // 计算理论曲线接口 (供 FittingWidget 使用)
-    ModelCurveData calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime = QVector<double>());
+    // 直接调用无界面求解器，不访问任何界面对象，可在工作线程中并发调用；反演方法与精度由 options 按次指定
+    // stats 非空时累加拉氏空间求值次数与估计误差
+    // options.coarseGrid 启用且时间点足够多时，在自适应粗网格上计算后插值 (插值误差并入 stats)
+    // 结果按 (模型, 参数, 时间网格, 反演方法与阶数, 粗网格选项) 缓存，重复计算直接返回缓存曲线 (不计求值次数)
+    // options.parallel.cancellation 被取消时提前返回不完整的结果，不写入缓存
+    ModelCurveData calculateTheoreticalCurve(ModelType type, const ModelParams& params, const QVector<double>& providedTime = QVector<double>(),
+                                             const SolverOptions& options = SolverOptions::highPrecision(),
+                                             InversionStats* stats = nullptr) const;
+
+    // 在预先构建的反演计划上计算理论曲线 (拟合时对同一观测时间网格复用 plan)
+    // parallel 指定时间点并行所用的线程池与分块大小
+    ModelCurveData calculateTheoreticalCurve(ModelType type, const ModelParams& params, const InversionPlan& plan,
+                                             InversionStats* stats = nullptr,
+                                             const ParallelOptions& parallel = ParallelOptions()) const;
+
+    // 理论曲线及其对拉氏空间无因次量与 gamaD 的精确偏导数 (前向自动微分，供拟合计算雅可比矩阵)
+    // 结果不进入曲线缓存；类型无效或 plan 为空时返回空结果
+    CurveSensitivity calculateSensitivity(ModelType type, const ModelParams& params, const InversionPlan& plan,
+                                          const QVector<Sensitivity>& directions, InversionStats* stats = nullptr,
+                                          const ParallelOptions& parallel = ParallelOptions()) const;
+
+    // 理论曲线缓存: dirPath 非空时从该目录 (项目文件夹) 加载持久化缓存，并在切换目录或析构时写回；
+    // 为空表示只在内存中缓存
+    void setCurveCacheDirectory(const QString& dirPath);
+    void clearCurveCache();
 
     // 获取默认参数 (供 FittingWidget 使用)
-    QMap<QString, double> getDefaultParameters(ModelType type);
-
-    // 设置所有模型的高精度模式
-    void setHighPrecision(bool high);
+    ModelParams getDefaultParameters(ModelType type);
 
     // 刷新所有模型的基础参数
     void updateAllModelsBasicParameters();
@@ -79,8 +106,15 @@ private:
     // 使用列表统一管理所有模型实例
     QVector<ModelWidget01_06*> m_modelWidgets;
 
+    // 模型1-6 的无界面求解器 (只读，线程安全)
+    QVector<CompositeModelSolver> m_solvers;
+
     ModelType m_currentModelType;
 
+    // 理论曲线 LRU 缓存 (内部加锁，const 计算接口中也可更新)
+    mutable ModelCurveCache m_curveCache;
+    QString m_curveCacheDir;
+
     // 数据缓存
     QVector<double> m_cachedObsTime;
     QVector<double> m_cachedObsPressure;
@@ -0,0 +1,77 @@
+/*
+ * modelparams.cpp
+ * 文件作用：模型参数定长索引表示的实现
+ * 功能描述：
+ * 1. 参数名与下标的对照表、默认值表
+ * 2. 与具名 QMap 参数表的相互转换
+ */
+
+#include "modelparams.h"
+
+namespace {
+// 与 Id 枚举一一对应
+const char* const kNames[ModelParams::Count] = {
+    "phi", "h", "mu", "B", "Ct", "q", "kf", "km", "L", "Lf", "LfD", "rmD", "reD",
+    "omega1", "omega2", "lambda1", "gamaD", "cD", "S", "nf"
+};
+
+// 未设置参数时求解器使用的默认值
+const double kDefaults[ModelParams::Count] = {
+    0.05, 20.0, 0.5, 1.05, 5e-4, 5.0, 1e-3, 0.0, 1000.0, 0.0, 0.0, 0.0, 0.0,
+    0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 4.0
+};
+}
+
+ModelParams::ModelParams()
+    : m_present(0)
+{
+    for (int i = 0; i < Count; ++i) m_values[i] = kDefaults[i];
+}
+
+bool ModelParams::updateDerived()
+{
+    if (!contains(L) || !contains(Lf) || m_values[L] <= 1e-9) return false;
+    set(LfD, m_values[Lf] / m_values[L]);
+    return true;
+}
+
+QString ModelParams::name(Id id)
+{
+    return (id >= 0 && id < Count) ? QString::fromLatin1(kNames[id]) : QString();
+}
+
+int ModelParams::indexOf(const QString& name)
+{
+    for (int i = 0; i < Count; ++i) {
+        if (name == QLatin1String(kNames[i])) return i;
+    }
+    return -1;
+}
+
+ModelParams ModelParams::fromMap(const QMap<QString, double>& map)
+{
+    ModelParams p;
+    for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+        int id = indexOf(it.key());
+        if (id >= 0) p.set(Id(id), it.value());
+    }
+    return p;
+}
+
+QMap<QString, double> ModelParams::toMap() const
+{
+    QMap<QString, double> map;
+    for (int i = 0; i < Count; ++i) {
+        if (contains(Id(i))) map.insert(QString::fromLatin1(kNames[i]), m_values[i]);
+    }
+    return map;
+}
+
+bool ModelParams::operator==(const ModelParams& other) const
+{
+    if (m_present != other.m_present) return false;
+    for (int i = 0; i < Count; ++i) {
+        if (m_values[i] != other.m_values[i]) return false;
+    }
+    return true;
+}
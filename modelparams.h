@@ -0,0 +1,76 @@
+/*
+ * modelparams.h
+ * 文件作用：模型参数的定长索引表示
+ * 功能描述：
+ * 1. 以枚举下标存放模型1-6 的全部参数，替代求解器与拟合内层循环中的 QMap<QString, double>
+ * 2. 定长数组存储，复制与取值不做字符串比较、不分配堆内存
+ * 3. 与具名参数表 (界面表格、项目文件 JSON) 之间只在边界处通过 fromMap / toMap 转换
+ * 4. 未设置的参数取求解器约定的默认值，contains() 用于区分"显式设置"与"默认值"
+ */
+
+#ifndef MODELPARAMS_H
+#define MODELPARAMS_H
+
+#include <QMap>
+#include <QMetaType>
+#include <QString>
+
+class ModelParams
+{
+public:
+    // 参数下标 (顺序决定缓存键的哈希顺序，新增参数请追加在 Count 之前)
+    enum Id {
+        Phi = 0,  // 孔隙度
+        H,        // 有效厚度 (m)
+        Mu,       // 粘度 (mPa·s)
+        B,        // 体积系数
+        Ct,       // 综合压缩系数 (MPa^-1)
+        Q,        // 产量 (m^3/d)
+        Kf,       // 内区渗透率 (mD)
+        Km,       // 外区渗透率 (mD)
+        L,        // 水平井长度 (m)
+        Lf,       // 裂缝半长 (m)
+        LfD,      // 无因次裂缝半长 Lf / L (派生参数)
+        RmD,      // 无因次复合半径
+        ReD,      // 无因次外边界半径 (0 表示无限大)
+        Omega1,   // 内区储容比
+        Omega2,   // 外区储容比
+        Lambda1,  // 窜流系数
+        GamaD,    // 无因次压敏系数
+        CD,       // 无因次井储系数
+        S,        // 表皮系数
+        Nf,       // 裂缝条数
+        Count
+    };
+
+    ModelParams();
+
+    double value(Id id) const { return m_values[id]; }
+    double operator[](Id id) const { return m_values[id]; }
+    void set(Id id, double v) { m_values[id] = v; m_present |= (1u << id); }
+    bool contains(Id id) const { return (m_present & (1u << id)) != 0; }
+
+    // 由 L 与 Lf 更新派生参数 LfD；二者未设置或 L 过小时不修改并返回 false
+    bool updateDerived();
+
+    // 参数名 (与界面表格、项目文件中的键一致)；未知参数名返回 -1
+    static QString name(Id id);
+    static int indexOf(const QString& name);
+    // 按对数尺度拟合/扰动时需排除的参数 (可取负值或为整数)
+    static bool isLinearScale(Id id) { return id == S || id == Nf; }
+
+    // 边界转换: 未知键被忽略；toMap 只输出显式设置的参数
+    static ModelParams fromMap(const QMap<QString, double>& map);
+    QMap<QString, double> toMap() const;
+
+    bool operator==(const ModelParams& other) const;
+    bool operator!=(const ModelParams& other) const { return !(*this == other); }
+
+private:
+    double m_values[Count];
+    quint32 m_present; // 第 i 位表示参数 i 已显式设置
+};
+
+Q_DECLARE_METATYPE(ModelParams)
+
+#endif // MODELPARAMS_H
@@ -0,0 +1,92 @@
+/*
+ * monotonecubicinterpolator.cpp
+ * 文件作用：保单调三次 Hermite 插值 (PCHIP) 实现
+ * 功能描述：
+ * 1. 内部节点: 相邻割线同号时取加权调和平均，否则斜率为 0 (局部极值)
+ * 2. 端点: 三点单边公式，并按 Fritsch-Carlson 条件限制幅值
+ */
+
+#include "monotonecubicinterpolator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// 端点斜率 (h0, h1 为相邻两个区间长度，d0, d1 为对应割线斜率)
+double endpointSlope(double h0, double h1, double d0, double d1)
+{
+    double m = ((2.0 * h0 + h1) * d0 - h0 * d1) / (h0 + h1);
+    if (m * d0 <= 0.0) return 0.0;
+    if (d0 * d1 <= 0.0 && std::abs(m) > std::abs(3.0 * d0)) return 3.0 * d0;
+    return m;
+}
+}
+
+MonotoneCubicInterpolator::MonotoneCubicInterpolator(const QVector<double>& x, const QVector<double>& y)
+    : m_x(x), m_y(y), m_slope(x.size(), 0.0)
+{
+    int n = m_x.size();
+    if (n < 2 || m_y.size() != n) return;
+
+    QVector<double> h(n - 1), delta(n - 1);
+    for (int i = 0; i < n - 1; ++i) {
+        h[i] = m_x[i + 1] - m_x[i];
+        delta[i] = (m_y[i + 1] - m_y[i]) / h[i];
+    }
+    if (n == 2) {
+        m_slope[0] = m_slope[1] = delta[0];
+        return;
+    }
+
+    for (int i = 1; i < n - 1; ++i) {
+        if (delta[i - 1] * delta[i] <= 0.0) continue;
+        double w1 = 2.0 * h[i] + h[i - 1];
+        double w2 = h[i] + 2.0 * h[i - 1];
+        m_slope[i] = (w1 + w2) / (w1 / delta[i - 1] + w2 / delta[i]);
+    }
+    m_slope[0] = endpointSlope(h[0], h[1], delta[0], delta[1]);
+    m_slope[n - 1] = endpointSlope(h[n - 2], h[n - 3], delta[n - 2], delta[n - 3]);
+}
+
+int MonotoneCubicInterpolator::intervalOf(double xq) const
+{
+    int n = m_x.size();
+    if (n < 2 || xq < m_x[0] || xq > m_x[n - 1]) return -1;
+    int i = int(std::upper_bound(m_x.constBegin(), m_x.constEnd(), xq) - m_x.constBegin()) - 1;
+    return std::min(i, n - 2);
+}
+
+double MonotoneCubicInterpolator::value(double xq) const
+{
+    int n = m_x.size();
+    if (n == 0) return 0.0;
+    if (n == 1 || xq <= m_x[0]) return m_y[0];
+    if (xq >= m_x[n - 1]) return m_y[n - 1];
+
+    int i = intervalOf(xq);
+    double h = m_x[i + 1] - m_x[i];
+    double s = (xq - m_x[i]) / h;
+    double s2 = s * s, s3 = s2 * s;
+    // Hermite 基函数
+    double h00 = 2.0 * s3 - 3.0 * s2 + 1.0;
+    double h10 = s3 - 2.0 * s2 + s;
+    double h01 = -2.0 * s3 + 3.0 * s2;
+    double h11 = s3 - s2;
+    return h00 * m_y[i] + h10 * h * m_slope[i] + h01 * m_y[i + 1] + h11 * h * m_slope[i + 1];
+}
+
+double MonotoneCubicInterpolator::derivative(double xq) const
+{
+    int i = intervalOf(xq);
+    if (i < 0) return 0.0;
+
+    double h = m_x[i + 1] - m_x[i];
+    double s = (xq - m_x[i]) / h;
+    double s2 = s * s;
+    // Hermite 基函数对 s 的导数，再除以 h 换算为对 x 的导数
+    double d00 = 6.0 * s2 - 6.0 * s;
+    double d10 = 3.0 * s2 - 4.0 * s + 1.0;
+    double d01 = -6.0 * s2 + 6.0 * s;
+    double d11 = 3.0 * s2 - 2.0 * s;
+    return (d00 * m_y[i] + d01 * m_y[i + 1]) / h + d10 * m_slope[i] + d11 * m_slope[i + 1];
+}
@@ -0,0 +1,33 @@
+/*
+ * monotonecubicinterpolator.h
+ * 文件作用：保单调三次 Hermite 插值 (PCHIP) 头文件
+ * 功能描述：
+ * 1. 节点斜率按 Fritsch-Butland 加权调和平均确定，数据单调的区间内插值结果也单调、不产生过冲
+ * 2. 节点横坐标须严格递增；查询点超出节点范围时取端点值
+ * 3. 同时给出插值函数的导数，供理论曲线在 (ln t, ln p) 空间插值时直接得到 dp/dln t
+ */
+
+#ifndef MONOTONECUBICINTERPOLATOR_H
+#define MONOTONECUBICINTERPOLATOR_H
+
+#include <QVector>
+
+class MonotoneCubicInterpolator
+{
+public:
+    MonotoneCubicInterpolator(const QVector<double>& x, const QVector<double>& y);
+
+    double value(double xq) const;
+    // 插值函数的导数 (查询点超出节点范围时为 0)
+    double derivative(double xq) const;
+
+private:
+    // xq 所在区间的左端点下标，返回 -1 表示超出范围
+    int intervalOf(double xq) const;
+
+    QVector<double> m_x;
+    QVector<double> m_y;
+    QVector<double> m_slope; // 各节点处的导数
+};
+
+#endif // MONOTONECUBICINTERPOLATOR_H
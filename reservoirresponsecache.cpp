@@ -0,0 +1,82 @@
+/*
+ * reservoirresponsecache.cpp
+ * 文件作用：拉氏空间储层响应缓存实现
+ * 功能描述：
+ * 1. 缓存键 = SHA-1(模型/反演头部、时间换算系数、储层参数、各节点组参考时间)
+ * 2. QCache 负责 LRU 淘汰，所有访问由互斥锁保护
+ */
+
+#include "reservoirresponsecache.h"
+
+#include <QCryptographicHash>
+#include <QMutexLocker>
+#include <cstring>
+
+namespace {
+// 按二进制位写入 double，-0 归一为 +0，保证相等的参数产生相同的键
+void addDouble(QCryptographicHash& hash, double v)
+{
+    if (v == 0.0) v = 0.0;
+    quint64 bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    hash.addData(QByteArray(reinterpret_cast<const char*>(&bits), sizeof(bits)));
+}
+
+void addInt(QCryptographicHash& hash, qint32 v)
+{
+    hash.addData(QByteArray(reinterpret_cast<const char*>(&v), sizeof(v)));
+}
+}
+
+ReservoirResponseCache::ReservoirResponseCache(int maxValues)
+    : m_cache(maxValues)
+{
+}
+
+QByteArray ReservoirResponseCache::makeKey(int modelType, const InversionPlan& plan, double timeScale,
+                                           const QVector<double>& reservoirValues)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    addInt(hash, modelType);
+    addInt(hash, plan.method());
+    addInt(hash, plan.order());
+    addDouble(hash, plan.quadratureTolerance());
+    addDouble(hash, timeScale);
+    addInt(hash, reservoirValues.size());
+    for (double v : reservoirValues) addDouble(hash, v);
+    // 拉氏变量 z 只由各组参考时间决定
+    addInt(hash, plan.groupCount());
+    for (int g = 0; g < plan.groupCount(); ++g) addDouble(hash, plan.groupReferenceTime(g));
+    return hash.result();
+}
+
+bool ReservoirResponseCache::find(const QByteArray& key, QVector<Complex>& values)
+{
+    QMutexLocker locker(&m_mutex);
+    QVector<Complex>* entry = m_cache.object(key);
+    if (!entry) return false;
+    values = *entry;
+    return true;
+}
+
+void ReservoirResponseCache::insert(const QByteArray& key, const QVector<Complex>& values)
+{
+    int cost = values.size();
+    if (cost <= 0) return;
+
+    QVector<Complex>* entry = new QVector<Complex>(values);
+    QMutexLocker locker(&m_mutex);
+    m_cache.insert(key, entry, cost); // 超出容量时 QCache 负责删除 entry
+}
+
+void ReservoirResponseCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.clear();
+}
+
+int ReservoirResponseCache::count() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.count();
+}
@@ -0,0 +1,46 @@
+/*
+ * reservoirresponsecache.h
+ * 文件作用：拉氏空间储层响应缓存头文件
+ * 功能描述：
+ * 1. 缓存一条曲线在全部反演节点上的储层响应 p̄wD(z) (施加井储表皮之前的值)
+ * 2. 键只包含决定 p̄wD(z) 的量: 模型类型、反演方法与阶数、无因次时间换算系数、储层参数、反演计划的时间网格；
+ *    cD、S、gamaD 以及只影响压力换算的 h、q、B 不参与，改变它们时直接命中
+ * 3. 命中后只需重新施加井储表皮公式并做反演求和，不再计算贝塞尔函数与裂缝影响系数
+ * 4. 基于 QCache 的有界 LRU 策略，容量按缓存的节点值总数计算；内部加锁，可被多个线程同时访问
+ */
+
+#ifndef RESERVOIRRESPONSECACHE_H
+#define RESERVOIRRESPONSECACHE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QMutex>
+#include <QVector>
+#include <complex>
+#include "laplaceinversion.h"
+
+class ReservoirResponseCache
+{
+public:
+    typedef std::complex<double> Complex;
+
+    // maxValues: 缓存中所有曲线的节点值总数上限
+    explicit ReservoirResponseCache(int maxValues = 400000);
+
+    // 构造缓存键。reservoirValues 为决定储层响应的全部参数 (按固定顺序)，数值按二进制位参与哈希
+    static QByteArray makeKey(int modelType, const InversionPlan& plan, double timeScale,
+                              const QVector<double>& reservoirValues);
+
+    // 查找节点值 (按 组号 * 节点数 + 节点号 排列)；QVector 隐式共享，命中时不复制数据
+    bool find(const QByteArray& key, QVector<Complex>& values);
+    void insert(const QByteArray& key, const QVector<Complex>& values);
+    void clear();
+
+    int count() const;
+
+private:
+    mutable QMutex m_mutex;
+    QCache<QByteArray, QVector<Complex>> m_cache;
+};
+
+#endif // RESERVOIRRESPONSECACHE_H
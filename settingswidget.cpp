@@ -102,6 +102,7 @@ void SettingsWidget::loadSettings()
     ui->spinAutoSave->setValue(m_settings->value("system/autoSaveInterval", DEFAULT_AUTO_SAVE).toInt());
     ui->chkEnableBackup->setChecked(m_settings->value("system/backupEnabled", true).toBool());
     ui->spinMaxBackups->setValue(m_settings->value("system/maxBackups", DEFAULT_MAX_BACKUPS).toInt());
+    ui->chkCurveCache->setChecked(m_settings->value("system/curveCachePersist", true).toBool());
     ui->chkCleanupLogs->setChecked(m_settings->value("system/cleanupLogs", true).toBool());
     ui->spinLogDays->setValue(m_settings->value("system/logRetention", 30).toInt());
     ui->cmbLogLevel->setCurrentIndex(m_settings->value("system/logLevel", 2).toInt());
@@ -135,6 +136,7 @@ void SettingsWidget::applySettings()
     m_settings->setValue("system/autoSaveInterval", ui->spinAutoSave->value());
     m_settings->setValue("system/backupEnabled", ui->chkEnableBackup->isChecked());
     m_settings->setValue("system/maxBackups", ui->spinMaxBackups->value());
+    m_settings->setValue("system/curveCachePersist", ui->chkCurveCache->isChecked());
     m_settings->setValue("system/cleanupLogs", ui->chkCleanupLogs->isChecked());
     m_settings->setValue("system/logRetention", ui->spinLogDays->value());
     m_settings->setValue("system/logLevel", ui->cmbLogLevel->currentIndex());
@@ -240,6 +242,7 @@ QString SettingsWidget::getReportPath() const { return ui->lineReportPath->text(
 QString SettingsWidget::getBackupPath() const { return ui->lineBackupPath->text(); }
 int SettingsWidget::getAutoSaveInterval() const { return ui->spinAutoSave->value(); }
 bool SettingsWidget::isBackupEnabled() const { return ui->chkEnableBackup->isChecked(); }
+bool SettingsWidget::isCurveCachePersistent() const { return ui->chkCurveCache->isChecked(); }
 int SettingsWidget::getPressureUnitIndex() const { return ui->cmbPressureUnit->currentIndex(); }
 int SettingsWidget::getRateUnitIndex() const { return ui->cmbRateUnit->currentIndex(); }
 int SettingsWidget::getPrecision() const { return ui->spinPrecision->value(); }
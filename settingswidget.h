@@ -41,6 +41,7 @@ public:
     // 系统配置
     int getAutoSaveInterval() const;
     bool isBackupEnabled() const;
+    bool isCurveCachePersistent() const; // 是否在项目文件夹中保存理论曲线缓存
 
     // 单位配置 [新增]
     int getPressureUnitIndex() const; // 0: MPa, 1: psi
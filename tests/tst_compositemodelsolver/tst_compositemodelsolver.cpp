@@ -0,0 +1,425 @@
+/*
+ * tst_compositemodelsolver.cpp
+ * 文件作用：无界面求解器 CompositeModelSolver 的单元测试与基准测试
+ * 功能描述：
+ * 1. Stehfest (N=8) 理论曲线与原 ModelWidget01_06 的计算结果一致 (模型1-6)
+ * 2. 等间距裂缝的 Toeplitz (Levinson) 求解与逐元素积分的稠密 LU 求解一致 (实数与复数拉氏变量)
+ * 3. Euler、定步长 Talbot、de Hoog 反演与 Stehfest 反演在容差内一致
+ * 4. calculateSensitivity 的自动微分偏导数与中心差分一致
+ * 5. ModelCurveCache 保存到文件后重新读取，曲线与误差估计不变
+ * 6. 单条理论曲线计算的基准测试
+ * 只依赖 Qt Core (QtConcurrent 为求解器的时间点并行所需)
+ */
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <cmath>
+#include <complex>
+
+#include "compositemodelsolver.h"
+#include "modelcurvecache.h"
+
+class TestCompositeModelSolver : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void stehfestMatchesBaseline_data();
+    void stehfestMatchesBaseline();
+    void toeplitzMatchesDense_data();
+    void toeplitzMatchesDense();
+    void inversionMethodsAgree_data();
+    void inversionMethodsAgree();
+    void sensitivityMatchesCentralDifference_data();
+    void sensitivityMatchesCentralDifference();
+    void curveCacheRoundTrip();
+    void benchmarkCurve();
+
+private:
+    // 与 ModelManager::getDefaultParameters 相同的默认参数 (基础参数取项目文件的默认值)
+    static ModelParams defaultParams(CompositeModelSolver::ModelType type);
+    // 覆盖井储段、双重介质过渡段与外边界段的时间点 (1e-2 ~ 1e6 h，每十倍一个点)
+    static QVector<double> testTimes() { return CompositeModelSolver::generateLogTimeSteps(9, -2.0, 6.0); }
+    // 储层响应: 按模型的外边界类型调用对应的实例
+    template<typename T>
+    static T reservoirResponse(CompositeModelSolver::ModelType type, const T& z,
+                               const CompositeModelSolver::LaplaceParams& lp);
+    // 把偏导数方向对应的参数设为 value (M12 = kf/km 通过 km 设置)
+    static void setDirection(ModelParams& params, CompositeModelSolver::Sensitivity direction, double value);
+    static double directionValue(const ModelParams& params, CompositeModelSolver::Sensitivity direction);
+};
+
+ModelParams TestCompositeModelSolver::defaultParams(CompositeModelSolver::ModelType type)
+{
+    ModelParams p;
+    p.set(ModelParams::Phi, 0.05);
+    p.set(ModelParams::H, 20.0);
+    p.set(ModelParams::Mu, 0.5);
+    p.set(ModelParams::B, 1.05);
+    p.set(ModelParams::Ct, 5e-4);
+    p.set(ModelParams::Q, 5.0);
+
+    p.set(ModelParams::Nf, 4.0);
+    p.set(ModelParams::Kf, 1e-3);
+    p.set(ModelParams::Km, 1e-4);
+    p.set(ModelParams::L, 1000.0);
+    p.set(ModelParams::Lf, 100.0);
+    p.set(ModelParams::LfD, 0.1);
+    p.set(ModelParams::RmD, 4.0);
+    p.set(ModelParams::Omega1, 0.4);
+    p.set(ModelParams::Omega2, 0.08);
+    p.set(ModelParams::Lambda1, 1e-3);
+    p.set(ModelParams::GamaD, 0.02);
+
+    bool storage = CompositeModelSolver::hasWellboreStorage(type);
+    p.set(ModelParams::CD, storage ? 0.01 : 0.0);
+    p.set(ModelParams::S, storage ? 1.0 : 0.0);
+    if (CompositeModelSolver::hasOuterBoundary(type)) p.set(ModelParams::ReD, 10.0);
+    return p;
+}
+
+template<typename T>
+T TestCompositeModelSolver::reservoirResponse(CompositeModelSolver::ModelType type, const T& z,
+                                              const CompositeModelSolver::LaplaceParams& lp)
+{
+    switch (type) {
+    case CompositeModelSolver::Model_1:
+    case CompositeModelSolver::Model_2:
+        return CompositeModelSolver::reservoirResponse<CompositeModelSolver::InfiniteBoundary, T>(z, lp);
+    case CompositeModelSolver::Model_3:
+    case CompositeModelSolver::Model_4:
+        return CompositeModelSolver::reservoirResponse<CompositeModelSolver::ClosedBoundary, T>(z, lp);
+    default:
+        return CompositeModelSolver::reservoirResponse<CompositeModelSolver::ConstantPressureBoundary, T>(z, lp);
+    }
+}
+
+void TestCompositeModelSolver::setDirection(ModelParams& params, CompositeModelSolver::Sensitivity direction, double value)
+{
+    switch (direction) {
+    case CompositeModelSolver::SensM12: params.set(ModelParams::Km, params[ModelParams::Kf] / value); break;
+    case CompositeModelSolver::SensLfD: params.set(ModelParams::LfD, value); break;
+    case CompositeModelSolver::SensRmD: params.set(ModelParams::RmD, value); break;
+    case CompositeModelSolver::SensReD: params.set(ModelParams::ReD, value); break;
+    case CompositeModelSolver::SensOmega1: params.set(ModelParams::Omega1, value); break;
+    case CompositeModelSolver::SensOmega2: params.set(ModelParams::Omega2, value); break;
+    case CompositeModelSolver::SensLambda1: params.set(ModelParams::Lambda1, value); break;
+    case CompositeModelSolver::SensCD: params.set(ModelParams::CD, value); break;
+    case CompositeModelSolver::SensS: params.set(ModelParams::S, value); break;
+    case CompositeModelSolver::SensGamaD: params.set(ModelParams::GamaD, value); break;
+    default: break;
+    }
+}
+
+double TestCompositeModelSolver::directionValue(const ModelParams& params, CompositeModelSolver::Sensitivity direction)
+{
+    switch (direction) {
+    case CompositeModelSolver::SensM12: return params[ModelParams::Kf] / params[ModelParams::Km];
+    case CompositeModelSolver::SensLfD: return params[ModelParams::LfD];
+    case CompositeModelSolver::SensRmD: return params[ModelParams::RmD];
+    case CompositeModelSolver::SensReD: return params[ModelParams::ReD];
+    case CompositeModelSolver::SensOmega1: return params[ModelParams::Omega1];
+    case CompositeModelSolver::SensOmega2: return params[ModelParams::Omega2];
+    case CompositeModelSolver::SensLambda1: return params[ModelParams::Lambda1];
+    case CompositeModelSolver::SensCD: return params[ModelParams::CD];
+    case CompositeModelSolver::SensS: return params[ModelParams::S];
+    case CompositeModelSolver::SensGamaD: return params[ModelParams::GamaD];
+    default: return 0.0;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 1. 与原 ModelWidget01_06 (Stehfest N=8，boost 贝塞尔函数，逐元素积分 + 稠密 LU) 的结果对比
+// ---------------------------------------------------------------------------
+void TestCompositeModelSolver::stehfestMatchesBaseline_data()
+{
+    QTest::addColumn<int>("modelType");
+    QTest::addColumn<QVector<double>>("expected");
+
+    // 由原 ModelWidget01_06::calculateTheoreticalCurve 在 testTimes() 上计算的压差 (MPa)
+    QTest::newRow("Model_1") << int(CompositeModelSolver::Model_1) << QVector<double>{
+        0.000278395686, 0.00276986364, 0.0263519965, 0.1693322, 0.266419748,
+        0.289765523, 0.351149812, 0.59104609, 0.956111621 };
+    QTest::newRow("Model_2") << int(CompositeModelSolver::Model_2) << QVector<double>{
+        0.000574917659, 0.00181805197, 0.00550277051, 0.0118405955, 0.0231074891,
+        0.0448795824, 0.104912977, 0.339853978, 0.697251829 };
+    QTest::newRow("Model_3") << int(CompositeModelSolver::Model_3) << QVector<double>{
+        0.000278395686, 0.00276986364, 0.0263519965, 0.1693322, 0.266419748,
+        0.289765455, 0.351229257, 0.738519809, 5.16240523 };
+    QTest::newRow("Model_4") << int(CompositeModelSolver::Model_4) << QVector<double>{
+        0.000574917659, 0.00181805197, 0.00550277051, 0.0118405955, 0.0231074891,
+        0.0448795144, 0.10499153, 0.484372741, 4.79834655 };
+    QTest::newRow("Model_5") << int(CompositeModelSolver::Model_5) << QVector<double>{
+        0.000278395686, 0.00276986364, 0.0263519965, 0.1693322, 0.266419748,
+        0.289765582, 0.351092022, 0.511243527, 0.529363221 };
+    QTest::newRow("Model_6") << int(CompositeModelSolver::Model_6) << QVector<double>{
+        0.000574917659, 0.00181805197, 0.00550277051, 0.0118405955, 0.0231074891,
+        0.0448796401, 0.104855722, 0.261647524, 0.279380951 };
+}
+
+void TestCompositeModelSolver::stehfestMatchesBaseline()
+{
+    QFETCH(int, modelType);
+    QFETCH(QVector<double>, expected);
+
+    CompositeModelSolver::ModelType type = CompositeModelSolver::ModelType(modelType);
+    CompositeModelSolver solver(type);
+    CompositeModelSolver::SolverOptions options;
+    options.inversionMethod = LaplaceInversion::Stehfest;
+    options.inversionOrder = 8;
+    options.parallel = CompositeModelSolver::ParallelOptions::serial();
+
+    ModelCurveData curve = solver.calculateTheoreticalCurve(defaultParams(type), testTimes(), options);
+    const QVector<double>& pressure = std::get<1>(curve);
+    QCOMPARE(pressure.size(), expected.size());
+
+    // 原实现的 Gauss 节点只有 6 位有效数字，积分容差 1e-5
+    for (int k = 0; k < expected.size(); ++k) {
+        double relError = std::abs(pressure[k] / expected[k] - 1.0);
+        QVERIFY2(relError < 1e-4, qPrintable(QString("t = %1 h: %2 vs %3")
+                                             .arg(testTimes()[k]).arg(pressure[k]).arg(expected[k])));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 2. 等间距裂缝: Toeplitz 递推与稠密 LU 求解的储层响应一致
+// ---------------------------------------------------------------------------
+void TestCompositeModelSolver::toeplitzMatchesDense_data()
+{
+    QTest::addColumn<int>("modelType");
+    QTest::addColumn<int>("fractureCount");
+
+    const int types[] = { CompositeModelSolver::Model_2, CompositeModelSolver::Model_4, CompositeModelSolver::Model_6 };
+    for (int type : types) {
+        for (int nf : { 2, 3, 5, 8 }) {
+            QTest::newRow(qPrintable(QString("Model_%1 nf=%2").arg(type + 1).arg(nf))) << type << nf;
+        }
+    }
+}
+
+void TestCompositeModelSolver::toeplitzMatchesDense()
+{
+    QFETCH(int, modelType);
+    QFETCH(int, fractureCount);
+
+    CompositeModelSolver::ModelType type = CompositeModelSolver::ModelType(modelType);
+    ModelParams params = defaultParams(type);
+    params.set(ModelParams::Nf, fractureCount);
+
+    CompositeModelSolver::LaplaceParams toeplitz =
+        CompositeModelSolver::prepareLaplaceParams(params, InversionPlan::DefaultQuadratureTolerance);
+    QVERIFY(toeplitz.uniformGrid);
+    CompositeModelSolver::LaplaceParams dense = toeplitz;
+    dense.uniformGrid = false;
+
+    for (double z : { 1e-4, 1e-2, 1.0, 1e2 }) {
+        // 实轴节点 (Stehfest)
+        double a = reservoirResponse<double>(type, z, toeplitz);
+        double b = reservoirResponse<double>(type, z, dense);
+        QVERIFY2(std::abs(a - b) <= 1e-10 * std::abs(b), qPrintable(QString("z = %1: %2 vs %3").arg(z).arg(a).arg(b)));
+
+        // 复平面节点 (Euler / Talbot / de Hoog)
+        std::complex<double> zc(z, z);
+        std::complex<double> ac = reservoirResponse<std::complex<double>>(type, zc, toeplitz);
+        std::complex<double> bc = reservoirResponse<std::complex<double>>(type, zc, dense);
+        QVERIFY2(std::abs(ac - bc) <= 1e-10 * std::abs(bc), qPrintable(QString("z = %1(1+i)").arg(z)));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 3. 复平面反演方法与 Stehfest 一致
+// ---------------------------------------------------------------------------
+void TestCompositeModelSolver::inversionMethodsAgree_data()
+{
+    QTest::addColumn<int>("modelType");
+    QTest::addColumn<int>("method");
+
+    for (int type = CompositeModelSolver::Model_1; type <= CompositeModelSolver::Model_6; ++type) {
+        QTest::newRow(qPrintable(QString("Model_%1 Euler").arg(type + 1))) << type << int(LaplaceInversion::Euler);
+        QTest::newRow(qPrintable(QString("Model_%1 Talbot").arg(type + 1))) << type << int(LaplaceInversion::FixedTalbot);
+        QTest::newRow(qPrintable(QString("Model_%1 de Hoog").arg(type + 1))) << type << int(LaplaceInversion::DeHoog);
+    }
+}
+
+void TestCompositeModelSolver::inversionMethodsAgree()
+{
+    QFETCH(int, modelType);
+    QFETCH(int, method);
+
+    CompositeModelSolver::ModelType type = CompositeModelSolver::ModelType(modelType);
+    CompositeModelSolver solver(type);
+    ModelParams params = defaultParams(type);
+
+    CompositeModelSolver::SolverOptions stehfestOptions = CompositeModelSolver::SolverOptions::highPrecision(LaplaceInversion::Stehfest);
+    stehfestOptions.parallel = CompositeModelSolver::ParallelOptions::serial();
+    CompositeModelSolver::SolverOptions methodOptions = CompositeModelSolver::SolverOptions::highPrecision(LaplaceInversion::Method(method));
+    methodOptions.parallel = CompositeModelSolver::ParallelOptions::serial();
+
+    ModelCurveData reference = solver.calculateTheoreticalCurve(params, testTimes(), stehfestOptions);
+    ModelCurveData curve = solver.calculateTheoreticalCurve(params, testTimes(), methodOptions);
+    const QVector<double>& refP = std::get<1>(reference);
+    const QVector<double>& refD = std::get<2>(reference);
+    const QVector<double>& p = std::get<1>(curve);
+    const QVector<double>& d = std::get<2>(curve);
+    QCOMPARE(p.size(), refP.size());
+
+    // 导数在定压边界晚期趋于 0，按整条导数曲线的量级比较；
+    // Stehfest 在井储驼峰后的导数低谷处误差约 1e-3 量级
+    double derivScale = 0.0;
+    for (double v : refD) derivScale = std::max(derivScale, std::abs(v));
+    for (int k = 0; k < refP.size(); ++k) {
+        QVERIFY2(std::abs(p[k] - refP[k]) <= 1e-3 * std::abs(refP[k]),
+                 qPrintable(QString("pressure at t = %1 h: %2 vs %3").arg(testTimes()[k]).arg(p[k]).arg(refP[k])));
+        QVERIFY2(std::abs(d[k] - refD[k]) <= 1e-2 * derivScale,
+                 qPrintable(QString("derivative at t = %1 h: %2 vs %3").arg(testTimes()[k]).arg(d[k]).arg(refD[k])));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 4. 自动微分偏导数与中心差分一致
+// ---------------------------------------------------------------------------
+void TestCompositeModelSolver::sensitivityMatchesCentralDifference_data()
+{
+    QTest::addColumn<int>("modelType");
+    QTest::addColumn<int>("method");
+
+    for (int type : { int(CompositeModelSolver::Model_1), int(CompositeModelSolver::Model_3), int(CompositeModelSolver::Model_6) }) {
+        QTest::newRow(qPrintable(QString("Model_%1 Stehfest").arg(type + 1))) << type << int(LaplaceInversion::Stehfest);
+        QTest::newRow(qPrintable(QString("Model_%1 de Hoog").arg(type + 1))) << type << int(LaplaceInversion::DeHoog);
+    }
+}
+
+void TestCompositeModelSolver::sensitivityMatchesCentralDifference()
+{
+    QFETCH(int, modelType);
+    QFETCH(int, method);
+
+    CompositeModelSolver::ModelType type = CompositeModelSolver::ModelType(modelType);
+    CompositeModelSolver solver(type);
+    ModelParams params = defaultParams(type);
+
+    QVector<CompositeModelSolver::Sensitivity> directions;
+    directions << CompositeModelSolver::SensM12 << CompositeModelSolver::SensLfD << CompositeModelSolver::SensRmD
+               << CompositeModelSolver::SensOmega1 << CompositeModelSolver::SensOmega2 << CompositeModelSolver::SensLambda1
+               << CompositeModelSolver::SensGamaD;
+    if (CompositeModelSolver::hasOuterBoundary(type)) directions << CompositeModelSolver::SensReD;
+    if (CompositeModelSolver::hasWellboreStorage(type)) directions << CompositeModelSolver::SensCD << CompositeModelSolver::SensS;
+
+    LaplaceInversion::Method inversionMethod = LaplaceInversion::Method(method);
+    InversionPlan plan(testTimes(), inversionMethod, LaplaceInversion::defaultOrder(inversionMethod, true));
+    CompositeModelSolver::ParallelOptions serial = CompositeModelSolver::ParallelOptions::serial();
+    CompositeModelSolver::CurveSensitivity sens = solver.calculateSensitivity(params, plan, directions, nullptr, serial);
+    QCOMPARE(sens.pressure.size(), directions.size());
+    QCOMPARE(sens.derivative.size(), directions.size());
+
+    // 自动微分的曲线与普通求值的曲线一致 (只差舍入误差；Stehfest 权重较大，舍入误差放大到 1e-10 量级)
+    ModelCurveData curve = solver.calculateTheoreticalCurve(params, plan, nullptr, serial);
+    for (int k = 0; k < plan.pointCount(); ++k) {
+        QVERIFY(std::abs(std::get<1>(sens.curve)[k] - std::get<1>(curve)[k]) <= 1e-8 * std::abs(std::get<1>(curve)[k]));
+    }
+
+    for (int i = 0; i < directions.size(); ++i) {
+        // 相对步长 1e-3: 更小的步长下影响系数积分的截断误差开始主导差分结果
+        double value = directionValue(params, directions[i]);
+        double h = 1e-3 * std::abs(value);
+        ModelParams plus = params, minus = params;
+        setDirection(plus, directions[i], value + h);
+        setDirection(minus, directions[i], value - h);
+        ModelCurveData curvePlus = solver.calculateTheoreticalCurve(plus, plan, nullptr, serial);
+        ModelCurveData curveMinus = solver.calculateTheoreticalCurve(minus, plan, nullptr, serial);
+
+        QVector<double> fdP(plan.pointCount()), fdD(plan.pointCount());
+        double scaleP = 0.0, scaleD = 0.0;
+        for (int k = 0; k < plan.pointCount(); ++k) {
+            fdP[k] = (std::get<1>(curvePlus)[k] - std::get<1>(curveMinus)[k]) / (2.0 * h);
+            fdD[k] = (std::get<2>(curvePlus)[k] - std::get<2>(curveMinus)[k]) / (2.0 * h);
+            scaleP = std::max(scaleP, std::abs(fdP[k]));
+            scaleD = std::max(scaleD, std::abs(fdD[k]));
+        }
+        for (int k = 0; k < plan.pointCount(); ++k) {
+            QVERIFY2(std::abs(sens.pressure[i][k] - fdP[k]) <= 2e-3 * scaleP,
+                     qPrintable(QString("direction %1, t = %2 h: dp %3 vs %4")
+                                .arg(int(directions[i])).arg(plan.time()[k]).arg(sens.pressure[i][k]).arg(fdP[k])));
+            QVERIFY2(std::abs(sens.derivative[i][k] - fdD[k]) <= 2e-3 * scaleD,
+                     qPrintable(QString("direction %1, t = %2 h: dd %3 vs %4")
+                                .arg(int(directions[i])).arg(plan.time()[k]).arg(sens.derivative[i][k]).arg(fdD[k])));
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 5. 曲线缓存持久化
+// ---------------------------------------------------------------------------
+void TestCompositeModelSolver::curveCacheRoundTrip()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString filePath = dir.filePath(ModelCurveCache::defaultFileName());
+
+    CompositeModelSolver::ModelType type = CompositeModelSolver::Model_3;
+    CompositeModelSolver solver(type);
+    ModelParams params = defaultParams(type);
+    CompositeModelSolver::SolverOptions options;
+    options.parallel = CompositeModelSolver::ParallelOptions::serial();
+
+    InversionStats curveStats;
+    ModelCurveData curve = solver.calculateTheoreticalCurve(params, testTimes(), options, &curveStats);
+    QByteArray key = ModelCurveCache::makeKey(int(type), params, testTimes(), options.inversionMethod,
+                                              options.inversionOrder, options.quadratureTolerance, options.coarseGrid);
+
+    ModelCurveCache cache;
+    cache.insert(key, curve, curveStats);
+    QCOMPARE(cache.count(), 1);
+    QVERIFY(cache.save(filePath));
+
+    ModelCurveCache restored;
+    QVERIFY(restored.load(filePath));
+    QCOMPARE(restored.count(), 1);
+
+    ModelCurveData loaded;
+    InversionStats loadedStats;
+    QVERIFY(restored.find(key, loaded, &loadedStats));
+    QCOMPARE(std::get<0>(loaded), std::get<0>(curve));
+    QCOMPARE(std::get<1>(loaded), std::get<1>(curve));
+    QCOMPARE(std::get<2>(loaded), std::get<2>(curve));
+    QCOMPARE(loadedStats.maxRelativeError, curveStats.maxRelativeError);
+    QCOMPARE(loadedStats.laplaceEvaluations, 0);
+
+    // 参数不同的键不命中
+    ModelParams other = params;
+    other.set(ModelParams::S, params[ModelParams::S] + 0.5);
+    QByteArray otherKey = ModelCurveCache::makeKey(int(type), other, testTimes(), options.inversionMethod,
+                                                   options.inversionOrder, options.quadratureTolerance, options.coarseGrid);
+    QVERIFY(!restored.find(otherKey, loaded));
+
+    // 损坏的文件被忽略
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write("not a curve cache");
+    file.close();
+    ModelCurveCache corrupted;
+    QVERIFY(!corrupted.load(filePath));
+    QCOMPARE(corrupted.count(), 0);
+}
+
+// ---------------------------------------------------------------------------
+// 6. 基准测试: 默认 100 点时间网格上的一条理论曲线 (串行，每次迭代使用新的求解器以避开储层响应缓存)
+// ---------------------------------------------------------------------------
+void TestCompositeModelSolver::benchmarkCurve()
+{
+    CompositeModelSolver::ModelType type = CompositeModelSolver::Model_3;
+    ModelParams params = defaultParams(type);
+    CompositeModelSolver::SolverOptions options;
+    options.parallel = CompositeModelSolver::ParallelOptions::serial();
+
+    ModelCurveData curve;
+    QBENCHMARK {
+        CompositeModelSolver solver(type);
+        curve = solver.calculateTheoreticalCurve(params, QVector<double>(), options);
+    }
+    QCOMPARE(int(std::get<0>(curve).size()), 100);
+}
+
+QTEST_GUILESS_MAIN(TestCompositeModelSolver)
+
+#include "tst_compositemodelsolver.moc"
@@ -0,0 +1,45 @@
+######################################################################
+# 无界面求解器 CompositeModelSolver 的单元测试与基准测试
+# 只依赖 Qt Core (QtConcurrent 为求解器的时间点并行所需)，直接编译主工程中的求解器源文件
+# 运行: qmake && make check；基准测试: ./tst_compositemodelsolver benchmarkCurve
+######################################################################
+QT = core testlib concurrent
+
+TEMPLATE = app
+TARGET = tst_compositemodelsolver
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+SRC_DIR = ../..
+INCLUDEPATH += $$SRC_DIR
+
+QMAKE_CXXFLAGS += -O3
+QMAKE_CXXFLAGS_RELEASE -= -O2
+QMAKE_CXXFLAGS_RELEASE += -O3
+
+unix: LIBS += -lm
+win32: LIBS += -lm
+
+HEADERS += $$SRC_DIR/besselfunctions.h \
+           $$SRC_DIR/cancellationtoken.h \
+           $$SRC_DIR/compositemodelsolver.h \
+           $$SRC_DIR/dualnumber.h \
+           $$SRC_DIR/laplaceinversion.h \
+           $$SRC_DIR/modelcurvecache.h \
+           $$SRC_DIR/modelparams.h \
+           $$SRC_DIR/monotonecubicinterpolator.h \
+           $$SRC_DIR/reservoirresponsecache.h
+
+SOURCES += tst_compositemodelsolver.cpp \
+           $$SRC_DIR/besselfunctions.cpp \
+           $$SRC_DIR/compositemodelsolver.cpp \
+           $$SRC_DIR/laplaceinversion.cpp \
+           $$SRC_DIR/modelcurvecache.cpp \
+           $$SRC_DIR/modelparams.cpp \
+           $$SRC_DIR/monotonecubicinterpolator.cpp \
+           $$SRC_DIR/reservoirresponsecache.cpp
+
+INCLUDEPATH += D:/08YYYXXX/eigen-3.3.8
+
+# 警告设置
+QMAKE_CXXFLAGS_WARN_ON += -Wno-unused-parameter
@@ -13,11 +13,16 @@
 #include "ui_wt_fittingwidget.h"
 #include "modelparameter.h"
 #include "modelselect.h"
+#include "fittingjobscheduler.h"
 
 #include <QtConcurrent>
+#include <QThreadPool>
+#include <QRandomGenerator>
+#include <QSet>
 #include <QMessageBox>
 #include <QDebug>
 #include <cmath>
+#include <algorithm>
 #include <QFileDialog>
 #include <QFile>
 #include <QTextStream>
@@ -44,7 +49,10 @@ FittingWidget::FittingWidget(QWidget *parent) :
     m_modelManager(nullptr),
     m_plotTitle(nullptr),
     m_currentModelType(ModelManager::Model_1),
-    m_isFitting(false)
+    m_isFitting(false),
+    m_jobScheduler(nullptr),
+    m_jobId(0),
+    m_bestStartError(0.0)
 {
     ui->setupUi(this);
 
@@ -65,6 +73,7 @@ FittingWidget::FittingWidget(QWidget *parent) :
 
     // 注册元类型
     qRegisterMetaType<QMap<QString,double>>("QMap<QString,double>");
+    qRegisterMetaType<ModelParams>("ModelParams");
     qRegisterMetaType<ModelManager::ModelType>("ModelManager::ModelType");
     qRegisterMetaType<QVector<double>>("QVector<double>");
 
@@ -72,6 +81,11 @@ FittingWidget::FittingWidget(QWidget *parent) :
     connect(this, &FittingWidget::sigIterationUpdated, this, &FittingWidget::onIterationUpdate, Qt::QueuedConnection);
     connect(this, &FittingWidget::sigProgress, ui->progressBar, &QProgressBar::setValue);
     connect(&m_watcher, &QFutureWatcher<void>::finished, this, &FittingWidget::onFitFinished);
+    connect(this, &FittingWidget::sigInversionStats, this, &FittingWidget::onInversionStats, Qt::QueuedConnection);
+    connect(this, &FittingWidget::sigFitLog, this, &FittingWidget::onFitLog, Qt::QueuedConnection);
+    connect(this, &FittingWidget::sigStartUpdated, this, &FittingWidget::onStartUpdated, Qt::QueuedConnection);
+    m_progressTimer.setInterval(kProgressFrameMs);
+    connect(&m_progressTimer, &QTimer::timeout, this, &FittingWidget::onProgressFrame);
 
     // [注意] 此处删除了 btnSelectParams 的手动 connect，避免弹窗出现两次
 
@@ -81,9 +95,31 @@ FittingWidget::FittingWidget(QWidget *parent) :
     ui->sliderWeight->setRange(0, 100);
     ui->sliderWeight->setValue(50);
     onSliderWeightChanged(50);
+
+    // --- 数值反演方法 (itemData 保存 LaplaceInversion::Method) ---
+    for (int i = 0; i < LaplaceInversion::methodCount(); ++i) {
+        ui->comboInversion->addItem(LaplaceInversion::methodName((LaplaceInversion::Method)i), i);
+    }
+    ui->comboInversion->setCurrentIndex(ui->comboInversion->findData((int)LaplaceInversion::Stehfest));
+
+    // --- 优化算法 (itemData 保存 FitSettings::Optimizer) ---
+    for (int i = 0; i < FitSettings::OptimizerCount; ++i) {
+        ui->comboOptimizer->addItem(FitSettings::optimizerName((FitSettings::Optimizer)i), i);
+    }
+    ui->comboOptimizer->setCurrentIndex(ui->comboOptimizer->findData((int)FitSettings::ClassicLM));
+
+    // --- 对数重采样的聚合方式 (itemData 保存 LogTimeResampler::Aggregation) ---
+    for (int i = 0; i < LogTimeResampler::AggregationCount; ++i) {
+        ui->comboAggregation->addItem(LogTimeResampler::aggregationName((LogTimeResampler::Aggregation)i), i);
+    }
+    ui->comboAggregation->setCurrentIndex(ui->comboAggregation->findData((int)LogTimeResampler::Median));
 }
 
-FittingWidget::~FittingWidget() { delete ui; }
+FittingWidget::~FittingWidget() {
+    // 任务函数引用本页，删除前先取消并等待其返回
+    if(m_jobScheduler && m_jobId > 0) m_jobScheduler->cancelAndWait(m_jobId);
+    delete ui;
+}
 
 void FittingWidget::setModelManager(ModelManager *m) {
     m_modelManager = m;
@@ -91,6 +127,17 @@ void FittingWidget::setModelManager(ModelManager *m) {
     initializeDefaultModel();
 }
 
+void FittingWidget::setJobScheduler(FittingJobScheduler* scheduler) {
+    m_jobScheduler = scheduler;
+    connect(scheduler, &FittingJobScheduler::jobDiscarded, this, &FittingWidget::onJobDiscarded);
+    // 本页的进度同时汇报给调度器，用于任务队列的进度与剩余时间估计
+    connect(ui->progressBar, &QProgressBar::valueChanged, this, [this](int value) {
+        if(m_jobScheduler && m_jobId > 0) m_jobScheduler->reportProgress(m_jobId, value);
+    });
+}
+
+void FittingWidget::setAnalysisName(const QString& name) { m_analysisName = name; }
+
 void FittingWidget::updateBasicParameters() {
     // 预留接口
 }
@@ -133,6 +180,17 @@ QJsonObject FittingWidget::getJsonState() const
     root["modelType"] = (int)m_currentModelType;
     root["modelName"] = ModelManager::getModelTypeName(m_currentModelType);
     root["fitWeightVal"] = ui->sliderWeight->value();
+    root["inversionMethod"] = ui->comboInversion->currentData().toInt();
+    root["coarseGrid"] = ui->chkCoarseGrid->isChecked();
+    root["progressiveFidelity"] = ui->chkProgressive->isChecked();
+    root["multiStart"] = ui->chkMultiStart->isChecked();
+    root["broydenUpdate"] = ui->chkBroyden->isChecked();
+    root["optimizer"] = ui->comboOptimizer->currentData().toInt();
+    root["resampling"] = ui->chkResample->isChecked();
+    root["resamplePointsPerDecade"] = ui->spinPointsPerDecade->value();
+    root["resampleAggregation"] = ui->comboAggregation->currentData().toInt();
+    root["countWeighting"] = ui->chkCountWeight->isChecked();
+    root["timeLimitSeconds"] = ui->spinTimeLimit->value();
 
     QJsonObject plotRange;
     plotRange["xMin"] = m_plot->xAxis->range().lower;
@@ -218,6 +276,43 @@ void FittingWidget::loadFittingState(const QJsonObject& root)
         ui->sliderWeight->setValue((int)(w * 100));
     }
 
+    if (root.contains("inversionMethod")) {
+        int idx = ui->comboInversion->findData(root["inversionMethod"].toInt());
+        if (idx >= 0) ui->comboInversion->setCurrentIndex(idx);
+    }
+    if (root.contains("coarseGrid")) {
+        ui->chkCoarseGrid->setChecked(root["coarseGrid"].toBool());
+    }
+    if (root.contains("multiStart")) {
+        ui->chkMultiStart->setChecked(root["multiStart"].toBool());
+    }
+    if (root.contains("progressiveFidelity")) {
+        ui->chkProgressive->setChecked(root["progressiveFidelity"].toBool());
+    }
+    if (root.contains("broydenUpdate")) {
+        ui->chkBroyden->setChecked(root["broydenUpdate"].toBool());
+    }
+    if (root.contains("optimizer")) {
+        int idx = ui->comboOptimizer->findData(root["optimizer"].toInt());
+        if (idx >= 0) ui->comboOptimizer->setCurrentIndex(idx);
+    }
+    if (root.contains("resampling")) {
+        ui->chkResample->setChecked(root["resampling"].toBool());
+    }
+    if (root.contains("resamplePointsPerDecade")) {
+        ui->spinPointsPerDecade->setValue(root["resamplePointsPerDecade"].toInt());
+    }
+    if (root.contains("resampleAggregation")) {
+        int idx = ui->comboAggregation->findData(root["resampleAggregation"].toInt());
+        if (idx >= 0) ui->comboAggregation->setCurrentIndex(idx);
+    }
+    if (root.contains("countWeighting")) {
+        ui->chkCountWeight->setChecked(root["countWeighting"].toBool());
+    }
+    if (root.contains("timeLimitSeconds")) {
+        ui->spinTimeLimit->setValue(root["timeLimitSeconds"].toInt());
+    }
+
     if (root.contains("observedData")) {
         QJsonObject obs = root["observedData"].toObject();
         QJsonArray tArr = obs["time"].toArray();
@@ -477,20 +572,140 @@ void FittingWidget::on_btnRunFit_clicked() {
     if(m_obsTime.isEmpty()) { QMessageBox::warning(this,"错误","请先加载观测数据。"); return; }
 
     m_paramChart->updateParamsFromTable();
-    m_isFitting = true; m_stopRequested = false; ui->btnRunFit->setEnabled(false);
+    m_isFitting = true;
+    ui->btnRunFit->setEnabled(false); ui->btnFitAllModels->setEnabled(false);
+    clearStartCurves();
 
     ModelManager::ModelType modelType = m_currentModelType;
     QList<FitParameter> paramsCopy = m_paramChart->getParameters();
 
     double w = ui->sliderWeight->value() / 100.0;
-    (void)QtConcurrent::run([this, modelType, paramsCopy, w](){ runOptimizationTask(modelType, paramsCopy, w); });
+    FitSettings settings = readFitSettings();
+    onFitLog(prepareFitData(settings));
+    m_progressBuffer.open();
+    m_progressTimer.start();
+    startFitJob(settings.multiStart ? "单模型拟合 (多起点)" : "单模型拟合", settings, [this, modelType, paramsCopy, w](const FitSettings& s) {
+        runOptimizationTask(modelType, paramsCopy, w, s);
+    });
+}
+
+void FittingWidget::on_btnFitAllModels_clicked() {
+    if(m_isFitting) return;
+    if(m_obsTime.isEmpty()) { QMessageBox::warning(this,"错误","请先加载观测数据。"); return; }
+    if(!m_modelManager) return;
+
+    m_paramChart->updateParamsFromTable();
+    QSet<QString> activeNames;
+    for(const FitParameter& p : m_paramChart->getParameters()) {
+        if(p.value != 0.0) activeNames.insert(p.name);
+    }
+
+    // 各模型的参数表: 公有参数沿用当前的数值与拟合设置；当前模型没有 (或不起作用) 的特有参数，如边界距离 reD、
+    // 井储系数与表皮系数，参与拟合，否则这些模型只能取默认值，无法与其它模型公平比较
+    QVector<ModelManager::ModelType> modelTypes;
+    QVector<QList<FitParameter>> modelParams;
+    for(int i = ModelManager::Model_1; i <= ModelManager::Model_6; ++i) {
+        ModelManager::ModelType type = (ModelManager::ModelType)i;
+        QList<FitParameter> params = m_paramChart->parametersForModel(type);
+        bool hasFitParams = false;
+        for(FitParameter& p : params) {
+            if(!activeNames.contains(p.name) && p.value != 0.0) p.isFit = true;
+            hasFitParams = hasFitParams || (p.isFit && ModelParams::indexOf(p.name) >= 0);
+        }
+        if(!hasFitParams) continue;
+        modelTypes.append(type);
+        modelParams.append(params);
+    }
+    if(modelTypes.isEmpty()) { QMessageBox::warning(this, "提示", "请先在参数选择中勾选需要拟合的参数。"); return; }
+
+    m_isFitting = true;
+    ui->btnRunFit->setEnabled(false); ui->btnFitAllModels->setEnabled(false);
+    clearStartCurves();
+    m_comparisonResults.clear();
+
+    double w = ui->sliderWeight->value() / 100.0;
+    FitSettings settings = readFitSettings();
+    onFitLog(prepareFitData(settings));
+    startFitJob(QString("多模型对比 (%1 个模型)").arg(modelTypes.size()), settings, [this, modelTypes, modelParams, w](const FitSettings& s) {
+        runModelComparison(modelTypes, modelParams, w, s);
+    });
 }
 
-void FittingWidget::runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight) {
-    runLevenbergMarquardtOptimization(modelType, fitParams, weight);
+void FittingWidget::startFitJob(const QString& description, const FitSettings& settings, const std::function<void(const FitSettings&)>& run) {
+    m_cancelToken = CancellationToken::create();
+    qint64 timeLimitMs = settings.timeLimitSeconds > 0 ? settings.timeLimitSeconds * 1000LL : -1;
+    CancellationToken token = m_cancelToken;
+    // 任务开始运行时才计时拟合时限 (排队等待不计入)
+    auto task = [settings, token, timeLimitMs, run](QThreadPool* pool) {
+        FitSettings s = settings;
+        s.threadPool = pool;
+        s.cancellation = timeLimitMs > 0 ? token.withTimeout(timeLimitMs) : token;
+        run(s);
+    };
+    if(!m_jobScheduler) {
+        (void)QtConcurrent::run([task](){ task(nullptr); });
+        return;
+    }
+    m_jobId = m_jobScheduler->submit(m_analysisName, description, m_cancelToken, timeLimitMs, task);
+    if(m_jobScheduler->status(m_jobId) == FittingJobScheduler::Queued)
+        onFitLog(QString("拟合任务 #%1 已加入队列，前面还有 %2 个任务在运行或排队").arg(m_jobId).arg(m_jobScheduler->runningCount() + m_jobScheduler->queuedCount() - 1));
+}
+
+void FittingWidget::onJobDiscarded(int jobId) {
+    if(jobId != m_jobId || !m_isFitting) return;
+    m_progressTimer.stop();
+    m_isFitting = false;
+    ui->btnRunFit->setEnabled(true); ui->btnFitAllModels->setEnabled(true);
+    onFitLog(QString("拟合任务 #%1 在排队中被取消").arg(jobId));
+}
+
+FittingWidget::FitSettings FittingWidget::readFitSettings() const {
+    FitSettings settings;
+    settings.inversionMethod = (LaplaceInversion::Method)ui->comboInversion->currentData().toInt();
+    settings.coarseGrid = ui->chkCoarseGrid->isChecked();
+    settings.progressiveFidelity = ui->chkProgressive->isChecked();
+    settings.broydenUpdate = ui->chkBroyden->isChecked();
+    settings.optimizer = (FitSettings::Optimizer)ui->comboOptimizer->currentData().toInt();
+    settings.multiStart = ui->chkMultiStart->isChecked();
+    settings.resampling.enabled = ui->chkResample->isChecked();
+    settings.resampling.pointsPerDecade = ui->spinPointsPerDecade->value();
+    settings.resampling.aggregation = (LogTimeResampler::Aggregation)ui->comboAggregation->currentData().toInt();
+    settings.countWeighting = ui->chkCountWeight->isChecked();
+    settings.timeLimitSeconds = ui->spinTimeLimit->value();
+    return settings;
+}
+
+QString FittingWidget::prepareFitData(const FitSettings& settings) {
+    m_fitWeight.clear();
+    if(!settings.resampling.enabled) {
+        m_fitTime = m_obsTime; m_fitPressure = m_obsPressure; m_fitDerivative = m_obsDerivative;
+        return QString("拟合使用全部 %1 个观测点").arg(m_obsTime.size());
+    }
+    // 每十倍时间只保留固定数目的代表点: 高频采样的晚期数据不再主导残差，残差求值的代价也与记录长度无关
+    LogTimeResampler::Result r = LogTimeResampler::resample(m_obsTime, m_obsPressure, m_obsDerivative, settings.resampling);
+    m_fitTime = r.time; m_fitPressure = r.pressure; m_fitDerivative = r.derivative;
+    if(settings.countWeighting && !r.count.isEmpty()) {
+        // 按原始点数加权时目标函数近似于全部观测点的残差平方和；权重归一化到平均值 1，MSE 与等权时量级相同
+        double mean = 0.0;
+        for(double c : r.count) mean += c;
+        mean /= r.count.size();
+        for(double c : r.count) m_fitWeight.append(std::sqrt(c / mean));
+    }
+    return QString("对数重采样 (%1, 每十倍 %2 点%3): %4 个观测点 → %5 个代表点")
+        .arg(LogTimeResampler::aggregationName(settings.resampling.aggregation)).arg(settings.resampling.pointsPerDecade)
+        .arg(settings.countWeighting ? ", 按点数加权" : "").arg(m_obsTime.size()).arg(m_fitTime.size());
 }
 
-void FittingWidget::on_btnStop_clicked() { m_stopRequested=true; }
+void FittingWidget::runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight, const FitSettings& settings) {
+    runLevenbergMarquardtOptimization(modelType, fitParams, weight, settings);
+}
+
+// 取消令牌在求解器内部逐节点轮询，正在进行的理论曲线计算也会尽快返回
+void FittingWidget::on_btnStop_clicked() {
+    m_cancelToken.cancel();
+    // 排队中的任务直接移出队列
+    if(m_jobScheduler && m_jobId > 0) m_jobScheduler->cancel(m_jobId);
+}
 void FittingWidget::on_btnImportModel_clicked() { updateModelCurve(); }
 
 void FittingWidget::on_btnExportData_clicked() {
@@ -555,47 +770,226 @@ void FittingWidget::updateModelCurve() {
     m_paramChart->updateParamsFromTable();
     QList<FitParameter> params = m_paramChart->getParameters();
 
-    QMap<QString,double> currentParams;
-    for(const auto& p : params) currentParams.insert(p.name, p.value);
-
-    if(currentParams.contains("L") && currentParams.contains("Lf") && currentParams["L"] > 1e-9)
-        currentParams["LfD"] = currentParams["Lf"] / currentParams["L"];
-    else currentParams["LfD"] = 0.0;
+    ModelParams currentParams = FittingParameterChart::toModelParams(params);
+    if(!currentParams.updateDerived()) currentParams.set(ModelParams::LfD, 0.0);
 
     ModelManager::ModelType type = m_currentModelType;
     QVector<double> targetT = m_obsTime;
     if(targetT.isEmpty()) { for(double e = -4; e <= 4; e += 0.1) targetT.append(pow(10, e)); }
 
-    ModelCurveData res = m_modelManager->calculateTheoreticalCurve(type, currentParams, targetT);
+    LaplaceInversion::Method method = (LaplaceInversion::Method)ui->comboInversion->currentData().toInt();
+    ModelManager::SolverOptions options = ModelManager::SolverOptions::highPrecision(method);
+    options.coarseGrid.enabled = ui->chkCoarseGrid->isChecked();
+    ModelCurveData res = m_modelManager->calculateTheoreticalCurve(type, currentParams, targetT, options);
     onIterationUpdate(0, currentParams, std::get<0>(res), std::get<1>(res), std::get<2>(res));
 }
 
-void FittingWidget::runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight) {
-    if(m_modelManager) m_modelManager->setHighPrecision(false);
+void FittingWidget::runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight, const FitSettings& settings) {
+    bool hasFitParams = false;
+    for(const FitParameter& p : params) hasFitParams = hasFitParams || (p.isFit && ModelParams::indexOf(p.name) >= 0);
+    if(!hasFitParams) { QMetaObject::invokeMethod(this, "onFitFinished"); return; }
+
+    // 单起点: 从参数表的初值出发按精度阶梯迭代；多起点: 全局搜索后取最优者
+    LMResult result = settings.multiStart
+        ? runMultiStartSearch(modelType, params, weight, settings)
+        : runLevenbergMarquardt(modelType, params, FittingParameterChart::toModelParams(params), weight, settings,
+                                fidelityLadder(settings), settings.maxIterations(), true);
+
+    // 之后的最终结果经信号发出，界面不再显示缓冲区中的迭代状态 (避免旧帧覆盖最终结果)
+    m_progressBuffer.close();
+    ModelParams currentParams = result.params;
+    currentParams.updateDerived();
+    QString prefix = FitSettings::optimizerName(settings.optimizer) + (settings.multiStart ? " | 多起点" : "") + " | ";
+    if(settings.cancellation.isCancelled()) {
+        // 停止或超时: 不再计算完整精度的最终曲线，保留迄今最优的参数与其所在精度下的曲线
+        if(!std::get<0>(result.curve).isEmpty())
+            emit sigIterationUpdated(result.mse(), currentParams, std::get<0>(result.curve), std::get<1>(result.curve), std::get<2>(result.curve));
+        emit sigInversionStats(result.stats.laplaceEvaluations, result.stats.maxRelativeError, result.stats.interpolationError);
+        emit sigFitLog(prefix + result.counters.summary(result.stats.laplaceEvaluations)
+                       + (settings.cancellation.reason() == CancellationToken::DeadlineExpired ? " | 已达到时限，保留当前最优参数" : " | 已停止，保留当前最优参数"));
+        QMetaObject::invokeMethod(this, "onFitFinished");
+        return;
+    }
+    InversionStats finalStats;
+    // 最终曲线取观测时间网格，与 updateModelCurve 的计算一致，之后刷新曲线时可命中缓存
+    ModelCurveData finalCurve = m_modelManager->calculateTheoreticalCurve(modelType, currentParams, m_obsTime, finalSolverOptions(settings), &finalStats);
+    emit sigIterationUpdated(result.mse(), currentParams, std::get<0>(finalCurve), std::get<1>(finalCurve), std::get<2>(finalCurve));
+    // 求值次数为整个拟合过程的累计值，误差取最终 (高精度) 曲线的估计值
+    emit sigInversionStats(result.stats.laplaceEvaluations + finalStats.laplaceEvaluations, finalStats.maxRelativeError,
+                           finalStats.interpolationError);
+    result.counters.curveEvaluations++;
+    bool converged = result.residualCount > 0 && result.mse() < kTargetMSE;
+    emit sigFitLog(prefix + result.counters.summary(result.stats.laplaceEvaluations + finalStats.laplaceEvaluations)
+                   + (converged ? " | 已达到收敛阈值" : " | 未达到收敛阈值"));
+    QMetaObject::invokeMethod(this, "onFitFinished");
+}
 
+FittingWidget::LMResult FittingWidget::runLevenbergMarquardt(ModelManager::ModelType modelType, const QList<FitParameter>& params, const ModelParams& start,
+                                                             double weight, const FitSettings& settings, const QVector<FidelityLevel>& ladder,
+                                                             int maxIter, bool interactive) {
+    // 迭代过程按精度阶梯逐级提高反演阶数与积分精度；精度按次传入求解器，不切换全局状态
+    // 启用粗网格时残差与曲线在自适应对数网格上计算后插值，计算量与观测数据的采样密度基本无关
+    int level = 0;
+    ModelManager::SolverOptions fitOptions = ladder[0].options;
+    // 反演节点分组在同一精度等级内只构建一次
+    InversionPlan fitPlan(m_fitTime, fitOptions.inversionMethod, fitOptions.inversionOrder, fitOptions.quadratureTolerance);
+    // 本次求解累计的拉氏空间求值次数与拟合日志计数
+    InversionStats fitStats;
+    FitCounters counters;
+
+    // 参与拟合的参数在此一次性映射为下标，迭代中不再按参数名查找
     QVector<int> fitIndices;
-    for(int i=0; i<params.size(); ++i) if(params[i].isFit) fitIndices.append(i);
+    QVector<ModelParams::Id> fitIds;
+    for(int i=0; i<params.size(); ++i) {
+        int id = ModelParams::indexOf(params[i].name);
+        if(params[i].isFit && id >= 0) { fitIndices.append(i); fitIds.append(ModelParams::Id(id)); }
+    }
     int nParams = fitIndices.size();
-    if(nParams == 0) { QMetaObject::invokeMethod(this, "onFitFinished"); return; }
-
-    double lambda = 0.01; int maxIter = 50; double currentSSE = 1e15;
-    QMap<QString, double> currentParamMap;
-    for(const auto& p : params) currentParamMap.insert(p.name, p.value);
 
-    if(currentParamMap.contains("L") && currentParamMap.contains("Lf") && currentParamMap["L"] > 1e-9)
-        currentParamMap["LfD"] = currentParamMap["Lf"] / currentParamMap["L"];
+    double lambda = 0.01; double currentSSE = 1e15;
+    ModelParams currentParams = start;
+    // 取消后求解器返回的曲线不完整 (未算完的节点为 0)，之后的任何求值结果都不能被接受
+    auto isCancelled = [&]() { return settings.cancellation.isCancelled(); };
 
-    QVector<double> residuals = calculateResiduals(currentParamMap, modelType, weight);
+    // 残差由当前点的理论曲线直接得到，同一条曲线也用于显示与无因次曲线
+    ModelCurveData currentCurve = calculateFitCurve(currentParams, modelType, fitPlan, fitOptions, &fitStats);
+    QVector<double> residuals = calculateResiduals(currentCurve, weight);
+    counters.curveEvaluations++;
     currentSSE = calculateSumSquaredError(residuals);
-    ModelCurveData curve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-    emit sigIterationUpdated(currentSSE/residuals.size(), currentParamMap, std::get<0>(curve), std::get<1>(curve), std::get<2>(curve));
+    if(isCancelled()) {
+        // 起点尚未算完: 返回起点参数，不带曲线
+        LMResult result;
+        result.params = start;
+        result.stats = fitStats;
+        result.counters = counters;
+        return result;
+    }
+    // 交互模式下把当前状态写入进度缓冲区 (按元素覆盖槽内已有的容器)，界面按固定帧率取最新一帧显示
+    int progress = 0;
+    auto publishProgress = [&]() {
+        if(!interactive) return;
+        auto copyInto = [](QVector<double>& dst, const QVector<double>& src) {
+            dst.resize(src.size());
+            std::copy(src.cbegin(), src.cend(), dst.begin());
+        };
+        FitProgressFrame& frame = m_progressBuffer.writeSlot();
+        frame.error = residuals.isEmpty() ? currentSSE : currentSSE / residuals.size();
+        frame.params = currentParams;
+        copyInto(frame.t, std::get<0>(currentCurve));
+        copyInto(frame.p, std::get<1>(currentCurve));
+        copyInto(frame.d, std::get<2>(currentCurve));
+        frame.progress = progress;
+        frame.stats = fitStats;
+        frame.counters = counters;
+        frame.optimizer = settings.optimizer;
+        frame.level = level;
+        frame.levelCount = ladder.size();
+        m_progressBuffer.publish();
+    };
+    publishProgress();
+    // 当前点的无因次曲线: 纯缩放参数 (phi, mu, Ct, h, q, B) 的雅可比列与只改变它们的试探步都由它平移插值得到
+    DimensionlessCurve shapeCurve(currentParams, currentCurve);
+
+    // J 只在当前点移动后重算 (试探步被拒绝时当前点不变，沿用原 J)；
+    // 拟牛顿模式: 接受步之后 J 由 Broyden 秩一更新得到，每 jacobianRefreshInterval 次更新或试探步被拒绝后完整重算
+    QVector<QVector<double>> J;
+    bool jacobianStale = true;
+    int updatesSinceRefresh = 0;
+    // Nielsen 阻尼的放大倍数与信赖域半径 (参数空间单位: 对数参数为 log10 增量)
+    double nu = 2.0;
+    double trustRadius = 1.0;
+    // 进入下一精度等级: 在当前参数处按新的精度重新计算残差与无因次曲线，J 随之完整重算
+    // 计算途中被取消时保留上一级的残差与曲线
+    auto promote = [&]() {
+        ModelManager::SolverOptions nextOptions = ladder[level + 1].options;
+        InversionPlan nextPlan(m_fitTime, nextOptions.inversionMethod, nextOptions.inversionOrder, nextOptions.quadratureTolerance);
+        ModelCurveData nextCurve = calculateFitCurve(currentParams, modelType, nextPlan, nextOptions, &fitStats);
+        QVector<double> nextResiduals = calculateResiduals(nextCurve, weight);
+        counters.curveEvaluations++;
+        if(isCancelled()) return;
+        ++level;
+        fitOptions = nextOptions;
+        fitPlan = nextPlan;
+        residuals = nextResiduals;
+        currentSSE = calculateSumSquaredError(residuals);
+        currentCurve = nextCurve;
+        shapeCurve = DimensionlessCurve(currentParams, currentCurve);
+        jacobianStale = true;
+        updatesSinceRefresh = 0;
+        lambda = 0.01; nu = 2.0; trustRadius = 1.0;
+        publishProgress();
+    };
+
+    // 由参数空间的步长 delta (对数参数为 log10 增量) 构造试探点；越界时截断，step 返回截断后的实际步长
+    auto makeTrial = [&](const QVector<double>& delta, QVector<double>& step) {
+        ModelParams trialParams = currentParams;
+        step.resize(nParams);
+        for(int i=0; i<nParams; ++i) {
+            int pIdx = fitIndices[i];
+            ModelParams::Id id = fitIds[i];
+            double oldVal = currentParams[id];
+            bool isLog = (oldVal > 1e-12 && !ModelParams::isLinearScale(id));
+            double newVal;
+            if(isLog) {
+                double logVal = log10(oldVal) + delta[i];
+                newVal = pow(10.0, logVal);
+            } else {
+                newVal = oldVal + delta[i];
+            }
+            newVal = qMax(params[pIdx].min, qMin(newVal, params[pIdx].max));
+            trialParams.set(id, newVal);
+            step[i] = isLog ? log10(newVal) - log10(oldVal) : newVal - oldVal;
+        }
+        trialParams.updateDerived();
+        return trialParams;
+    };
+    // 接受试探步: 拟牛顿模式下对 J 做 Broyden 秩一更新 J += (Δr - J s) s^T / (s^T s)，随后移动当前点并刷新界面
+    auto acceptTrial = [&](const CurveTask& trial, const QVector<double>& s, double newSSE) {
+        if(isCancelled()) return false;
+        int nRes = residuals.size();
+        double ss = 0.0; for(int i=0; i<nParams; ++i) ss += s[i] * s[i];
+        if(settings.broydenUpdate && trial.residuals.size() == nRes && ss > 1e-30) {
+            for(int r=0; r<nRes; ++r) {
+                double js = 0.0; for(int i=0; i<nParams; ++i) js += J[r][i] * s[i];
+                double c = (trial.residuals[r] - residuals[r] - js) / ss;
+                for(int i=0; i<nParams; ++i) J[r][i] += c * s[i];
+            }
+            counters.broydenUpdates++;
+            updatesSinceRefresh++;
+        } else {
+            jacobianStale = true;
+        }
+        currentSSE = newSSE; currentParams = trial.params; residuals = trial.residuals; currentCurve = trial.curve;
+        if(!trial.scaled) shapeCurve = DimensionlessCurve(currentParams, trial.curve);
+        publishProgress();
+        return true;
+    };
+    // 单个试探点求值 (只改变纯缩放参数时由无因次曲线平移得到)
+    auto evaluateTrial = [&](const ModelParams& trialParams) {
+        QVector<CurveTask> tasks(1, CurveTask(trialParams, shapeCurve.hasSameShape(trialParams)));
+        evaluateCurveTasks(tasks, shapeCurve, modelType, weight, fitPlan, fitOptions, &fitStats, &counters);
+        return tasks[0];
+    };
+    auto norm = [](const QVector<double>& v) { double s = 0.0; for(double x : v) s += x * x; return std::sqrt(s); };
 
     for(int iter = 0; iter < maxIter; ++iter) {
-        if(m_stopRequested) break;
-        if (!residuals.isEmpty() && (currentSSE / residuals.size()) < 3e-3) break;
+        if(isCancelled()) break;
+        if (!residuals.isEmpty() && (currentSSE / residuals.size()) < kTargetMSE) {
+            // 低精度下达到收敛阈值时先升到最高精度继续迭代，保证收敛判断与最后几步都在完整精度下进行
+            if(level + 1 < ladder.size()) { promote(); continue; }
+            break;
+        }
 
-        emit sigProgress(iter * 100 / maxIter);
-        QVector<QVector<double>> J = computeJacobian(currentParamMap, residuals, fitIndices, modelType, params, weight);
+        progress = iter * 100 / maxIter;
+        publishProgress();
+        counters.iterations++;
+        if(jacobianStale || (settings.broydenUpdate && updatesSinceRefresh >= settings.jacobianRefreshInterval)) {
+            J = computeJacobian(currentParams, residuals, fitIds, modelType, weight, fitPlan, fitOptions, shapeCurve, &fitStats, &counters);
+            counters.jacobianEvaluations++;
+            jacobianStale = false;
+            updatesSinceRefresh = 0;
+            if(isCancelled()) break;
+        }
         int nRes = residuals.size();
 
         QVector<QVector<double>> H(nParams, QVector<double>(nParams, 0.0));
@@ -607,88 +1001,619 @@ void FittingWidget::runLevenbergMarquardtOptimization(ModelManager::ModelType mo
             }
         }
         for(int i=0; i<nParams; ++i) for(int j=i+1; j<nParams; ++j) H[i][j] = H[j][i];
+        QVector<double> negG(nParams); for(int i=0;i<nParams;++i) negG[i] = -g[i];
 
-        bool stepAccepted = false;
-        for(int tryIter=0; tryIter<5; ++tryIter) {
+        // 阻尼方程 (H + mu·diag(1 + |H_ii|)) x = rhs
+        auto solveDamped = [&](double mu, const QVector<double>& rhs) {
             QVector<QVector<double>> H_lm = H;
-            for(int i=0; i<nParams; ++i) H_lm[i][i] += lambda * (1.0 + std::abs(H[i][i]));
-            QVector<double> negG(nParams); for(int i=0;i<nParams;++i) negG[i] = -g[i];
-            QVector<double> delta = solveLinearSystem(H_lm, negG);
+            for(int i=0; i<nParams; ++i) H_lm[i][i] += mu * (1.0 + std::abs(H[i][i]));
+            return solveLinearSystem(H_lm, rhs);
+        };
+        // 线性化模型预测的 SSE 下降量: |r|^2 - |r + J s|^2 = -2 g^T s - s^T H s
+        auto predictedReduction = [&](const QVector<double>& s) {
+            double pred = 0.0;
+            for(int i=0; i<nParams; ++i) {
+                double hs = 0.0; for(int j=0; j<nParams; ++j) hs += H[i][j] * s[j];
+                pred -= 2.0 * g[i] * s[i] + s[i] * hs;
+            }
+            return pred;
+        };
 
-            QMap<QString, double> trialMap = currentParamMap;
+        double iterationStartSSE = currentSSE;
+        bool stepAccepted = false;
+        bool stalled = false; // 阻尼过大或信赖域过小，当前精度下无法继续下降
+        if(settings.optimizer == FitSettings::ClassicLM) {
+            // 不同阻尼因子的试探步互相独立: 按线程数成批并行求值，取其中阻尼最小的下降步，结果与逐个尝试相同
+            const int maxTries = 5;
+            QThreadPool* pool = fitOptions.parallel.threadPool ? fitOptions.parallel.threadPool : QThreadPool::globalInstance();
+            int batchSize = qBound(1, pool->maxThreadCount(), maxTries);
+            for(int tryBegin=0; tryBegin<maxTries && !stepAccepted; tryBegin += batchSize) {
+                QVector<CurveTask> trials;
+                QVector<double> trialLambdas;
+                QVector<QVector<double>> trialSteps; // 截断到参数范围后的实际步长 (与 J 的列同一尺度)
+                for(int tryIter=tryBegin; tryIter<qMin(maxTries, tryBegin + batchSize); ++tryIter) {
+                    double trialLambda = lambda * pow(10.0, tryIter - tryBegin);
+                    QVector<double> step;
+                    ModelParams trialParams = makeTrial(solveDamped(trialLambda, negG), step);
+                    // 试探步只改变纯缩放参数时，曲线由当前无因次曲线平移得到
+                    trials.append(CurveTask(trialParams, shapeCurve.hasSameShape(trialParams)));
+                    trialLambdas.append(trialLambda);
+                    trialSteps.append(step);
+                }
+                evaluateCurveTasks(trials, shapeCurve, modelType, weight, fitPlan, fitOptions, &fitStats, &counters);
+
+                for(int k=0; k<trials.size(); ++k) {
+                    double newSSE = calculateSumSquaredError(trials[k].residuals);
+                    if(newSSE < currentSSE) {
+                        stepAccepted = acceptTrial(trials[k], trialSteps[k], newSSE);
+                        if(stepAccepted) lambda = trialLambdas[k] / 10.0;
+                        break;
+                    }
+                }
+                if(isCancelled()) break;
+                if(!stepAccepted) lambda = trialLambdas.last() * 10.0;
+            }
+            if(!stepAccepted && lambda > 1e10) stalled = true;
+        } else if(settings.optimizer == FitSettings::NielsenLM || settings.optimizer == FitSettings::GeodesicLM) {
+            // Nielsen 阻尼: 按实际与预测下降量之比 rho 连续调整 mu，被拒绝时 mu 按 nu 递增放大
+            QVector<double> v = solveDamped(lambda, negG);
+            QVector<double> delta = v;
+            bool acceptable = true;
+            if(settings.optimizer == FitSettings::GeodesicLM) {
+                // 测地线加速: 沿速度 v 多求值一个残差，由有限差分得到二阶方向导数 r'' ≈ 2/h·((r(x+hv) - r(x))/h - J v)，
+                // 加速度 a 满足 (H + mu·D) a = -J^T r''，步长取 v + a/2；|a| 相对 |v| 过大时视同拒绝
+                const double h = 0.1;
+                QVector<double> hv(nParams); for(int i=0; i<nParams; ++i) hv[i] = h * v[i];
+                QVector<double> hs;
+                CurveTask probe = evaluateTrial(makeTrial(hv, hs));
+                if(probe.residuals.size() == nRes) {
+                    QVector<double> rhs(nParams, 0.0);
+                    for(int k=0; k<nRes; ++k) {
+                        double jv = 0.0; for(int i=0; i<nParams; ++i) jv += J[k][i] * hs[i];
+                        double rpp = 2.0 / h * ((probe.residuals[k] - residuals[k]) - jv) / h;
+                        for(int i=0; i<nParams; ++i) rhs[i] -= J[k][i] * rpp;
+                    }
+                    QVector<double> a = solveDamped(lambda, rhs);
+                    const double alpha = 0.75;
+                    if(2.0 * norm(a) <= alpha * norm(v)) {
+                        for(int i=0; i<nParams; ++i) delta[i] = v[i] + 0.5 * a[i];
+                    } else {
+                        acceptable = false;
+                    }
+                }
+            }
+            if(acceptable) {
+                QVector<double> step;
+                CurveTask trial = evaluateTrial(makeTrial(delta, step));
+                double newSSE = calculateSumSquaredError(trial.residuals);
+                double pred = predictedReduction(step);
+                if(newSSE < currentSSE && pred > 0.0) {
+                    double rho = (currentSSE - newSSE) / pred;
+                    lambda *= qMax(1.0 / 3.0, 1.0 - pow(2.0 * rho - 1.0, 3));
+                    nu = 2.0;
+                    stepAccepted = acceptTrial(trial, step, newSSE);
+                }
+            }
+            if(!stepAccepted) { lambda *= nu; nu *= 2.0; }
+            if(!stepAccepted && lambda > 1e10) stalled = true;
+        } else {
+            // 狗腿信赖域: 在 Gauss-Newton 步与最速下降 (Cauchy) 步之间按信赖域半径折中；半径按 rho 放大或缩小
+            QVector<double> gn = solveDamped(1e-10, negG);
+            double gg = 0.0, gHg = 0.0;
             for(int i=0; i<nParams; ++i) {
-                int pIdx = fitIndices[i];
-                QString pName = params[pIdx].name;
-                double oldVal = currentParamMap[pName];
-                bool isLog = (oldVal > 1e-12 && pName != "S" && pName != "nf");
-                double newVal;
-                if(isLog) {
-                    double logVal = log10(oldVal) + delta[i];
-                    newVal = pow(10.0, logVal);
+                gg += g[i] * g[i];
+                for(int j=0; j<nParams; ++j) gHg += g[i] * H[i][j] * g[j];
+            }
+            if(gg <= 0.0 || gHg <= 0.0) {
+                stalled = true; // 梯度为零，已位于驻点
+            } else {
+                QVector<double> sd(nParams); for(int i=0; i<nParams; ++i) sd[i] = -gg / gHg * g[i];
+                double gnNorm = norm(gn), sdNorm = norm(sd);
+                QVector<double> delta(nParams);
+                if(gnNorm <= trustRadius) {
+                    delta = gn;
+                } else if(sdNorm >= trustRadius) {
+                    for(int i=0; i<nParams; ++i) delta[i] = sd[i] * trustRadius / sdNorm;
                 } else {
-                    newVal = oldVal + delta[i];
+                    // |sd + beta (gn - sd)| = trustRadius 的正根
+                    double a = 0.0, b = 0.0;
+                    for(int i=0; i<nParams; ++i) { double d = gn[i] - sd[i]; a += d * d; b += 2.0 * sd[i] * d; }
+                    double c = sdNorm * sdNorm - trustRadius * trustRadius;
+                    double beta = (-b + std::sqrt(qMax(0.0, b * b - 4.0 * a * c))) / (2.0 * a);
+                    for(int i=0; i<nParams; ++i) delta[i] = sd[i] + beta * (gn[i] - sd[i]);
+                }
+                QVector<double> step;
+                CurveTask trial = evaluateTrial(makeTrial(delta, step));
+                double newSSE = calculateSumSquaredError(trial.residuals);
+                double pred = predictedReduction(step);
+                double rho = pred > 0.0 ? (currentSSE - newSSE) / pred : -1.0;
+                double stepNorm = norm(step);
+                if(rho > 0.75) trustRadius = qMax(trustRadius, 3.0 * stepNorm);
+                else if(rho < 0.25) trustRadius = 0.5 * (stepNorm > 0.0 ? qMin(trustRadius, stepNorm) : trustRadius);
+                if(newSSE < currentSSE && rho > 0.0) {
+                    stepAccepted = acceptTrial(trial, step, newSSE);
                 }
-                newVal = qMax(params[pIdx].min, qMin(newVal, params[pIdx].max));
-                trialMap[pName] = newVal;
+                if(!stepAccepted && trustRadius < 1e-8) stalled = true;
             }
-            if(trialMap.contains("L") && trialMap.contains("Lf") && trialMap["L"] > 1e-9) trialMap["LfD"] = trialMap["Lf"] / trialMap["L"];
-
-            QVector<double> newRes = calculateResiduals(trialMap, modelType, weight);
-            double newSSE = calculateSumSquaredError(newRes);
-            if(newSSE < currentSSE) {
-                currentSSE = newSSE; currentParamMap = trialMap; residuals = newRes; lambda /= 10.0; stepAccepted = true;
-                ModelCurveData iterCurve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-                emit sigIterationUpdated(currentSSE/nRes, currentParamMap, std::get<0>(iterCurve), std::get<1>(iterCurve), std::get<2>(iterCurve));
-                break;
-            } else { lambda *= 10.0; }
         }
-        if(!stepAccepted && lambda > 1e10) break;
+        if(isCancelled()) break;
+        // 试探步被拒绝: 近似的 J 可能已失准，下一次迭代完整重算 (刚重算过的 J 保留)
+        if(!stepAccepted && updatesSinceRefresh > 0) jacobianStale = true;
+
+        // 精度阶梯: SSE 相对下降量低于本级阈值或本级已停滞时进入下一级；最高一级停滞即结束
+        bool lastLevel = level + 1 >= ladder.size();
+        if(stalled) {
+            if(lastLevel) break;
+            promote();
+        } else if(stepAccepted && !lastLevel && iterationStartSSE - currentSSE < ladder[level].promoteBelow * iterationStartSSE) {
+            promote();
+        }
     }
 
-    if(m_modelManager) m_modelManager->setHighPrecision(true);
-    if(currentParamMap.contains("L") && currentParamMap.contains("Lf") && currentParamMap["L"] > 1e-9)
-        currentParamMap["LfD"] = currentParamMap["Lf"] / currentParamMap["L"];
-    ModelCurveData finalCurve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-    emit sigIterationUpdated(currentSSE/residuals.size(), currentParamMap, std::get<0>(finalCurve), std::get<1>(finalCurve), std::get<2>(finalCurve));
-    QMetaObject::invokeMethod(this, "onFitFinished");
+    LMResult result;
+    result.params = currentParams;
+    result.sse = currentSSE;
+    result.residualCount = residuals.size();
+    result.curve = currentCurve;
+    result.stats = fitStats;
+    result.counters = counters;
+    return result;
 }
 
-QVector<double> FittingWidget::calculateResiduals(const QMap<QString, double>& params, ModelManager::ModelType modelType, double weight) {
-    if(!m_modelManager || m_obsTime.isEmpty()) return QVector<double>();
-    ModelCurveData res = m_modelManager->calculateTheoreticalCurve(modelType, params, m_obsTime);
+FittingWidget::LMResult FittingWidget::runMultiStartSearch(ModelManager::ModelType modelType, const QList<FitParameter>& params, double weight,
+                                                           const FitSettings& settings) {
+    QVector<int> fitIndices;
+    QVector<ModelParams::Id> fitIds;
+    for(int i=0; i<params.size(); ++i) {
+        int id = ModelParams::indexOf(params[i].name);
+        if(params[i].isFit && id >= 0) { fitIndices.append(i); fitIds.append(ModelParams::Id(id)); }
+    }
+    int nParams = fitIndices.size();
+
+    // 拉丁超立方抽样: 每个参数的 [min, max] 等分为 n 层，各层恰好抽到一次 (正值的对数类参数在 log10 空间分层)；
+    // 参数表中的初值作为第 0 个起点，固定种子使同一设置的搜索可以复现
+    const ModelParams tableStart = FittingParameterChart::toModelParams(params);
+    const int startCount = qMax(2, settings.multiStartCount);
+    const int sampleCount = startCount - 1;
+    QRandomGenerator rng(settings.multiStartSeed);
+    QVector<QVector<int>> strata(nParams);
+    for(int i=0; i<nParams; ++i) {
+        strata[i].resize(sampleCount);
+        for(int k=0; k<sampleCount; ++k) strata[i][k] = k;
+        for(int k=sampleCount-1; k>0; --k) std::swap(strata[i][k], strata[i][rng.bounded(k + 1)]);
+    }
+    QVector<LMResult> runs(startCount);
+    runs[0].params = tableStart;
+    for(int k=0; k<sampleCount; ++k) {
+        ModelParams p = tableStart;
+        for(int i=0; i<nParams; ++i) {
+            const FitParameter& fp = params[fitIndices[i]];
+            double u = (strata[i][k] + rng.generateDouble()) / sampleCount;
+            bool isLog = fp.min > 0.0 && !ModelParams::isLinearScale(fitIds[i]);
+            double v = isLog ? pow(10.0, log10(fp.min) + u * (log10(fp.max) - log10(fp.min))) : fp.min + u * (fp.max - fp.min);
+            p.set(fitIds[i], v);
+        }
+        p.updateDerived();
+        runs[k + 1].params = p;
+    }
+
+    // 每个起点按一个任务并行运行；任务内部的曲线求值仍可使用线程池，阻塞等待时调用线程参与计算
+    QAtomicInt finishedRuns(0);
+    const int totalRuns = startCount * kMultiStartRounds + qMin(settings.multiStartPolishCount, startCount);
+    LMResult* runData = runs.data(); // 各任务只写自己的元素
+    QThreadPool* pool = settings.threadPool ? settings.threadPool : QThreadPool::globalInstance();
+    auto runBatch = [&](QVector<int> indices, const QVector<FidelityLevel>& ladder, int maxIter) {
+        QtConcurrent::blockingMap(pool, indices, [&](int k) {
+            if(settings.cancellation.isCancelled()) return;
+            LMResult r = runLevenbergMarquardt(modelType, params, runData[k].params, weight, settings, ladder, maxIter, false);
+            // 本轮起点未算完即被取消时保留上一轮的结果
+            if(std::get<0>(r.curve).isEmpty() && !std::get<0>(runData[k].curve).isEmpty()) return;
+            // 起点的计数随各轮累加
+            r.counters.merge(runData[k].counters);
+            r.stats.merge(runData[k].stats);
+            runData[k] = r;
+            emit sigStartUpdated(k, r.mse(), r.params, std::get<0>(r.curve), std::get<1>(r.curve), std::get<2>(r.curve));
+            emit sigProgress((finishedRuns.fetchAndAddRelaxed(1) + 1) * 100 / totalRuns);
+        });
+    };
+    auto byMSE = [&](int a, int b) { return runs[a].mse() < runs[b].mse(); };
+
+    // 探索: 全部起点在最低精度下各迭代若干轮，每轮后淘汰 MSE 落后最优者 kMultiStartPruneRatio 倍以上的起点
+    QVector<FidelityLevel> explore(1, fidelityLadder(settings).first());
+    QVector<int> alive;
+    for(int k=0; k<startCount; ++k) alive.append(k);
+    for(int round=0; round<kMultiStartRounds && !settings.cancellation.isCancelled(); ++round) {
+        runBatch(alive, explore, kMultiStartRoundIterations);
+        std::sort(alive.begin(), alive.end(), byMSE);
+        double bestMSE = runs[alive.first()].mse();
+        QVector<int> kept;
+        for(int k : alive) {
+            if(kept.size() < settings.multiStartPolishCount || runs[k].mse() <= kMultiStartPruneRatio * bestMSE) kept.append(k);
+        }
+        // 被淘汰的起点不再运行，进度按其剩余轮数补齐
+        finishedRuns.fetchAndAddRelaxed((alive.size() - kept.size()) * (kMultiStartRounds - round - 1));
+        alive = kept;
+        emit sigFitLog(QString("多起点搜索: 第 %1/%2 轮，保留 %3/%4 个起点，最优 MSE %5")
+                           .arg(round + 1).arg(kMultiStartRounds).arg(alive.size()).arg(startCount).arg(bestMSE, 0, 'e', 3));
+    }
+
+    // 精修: 最优的几个起点以完整精度继续迭代
+    QVector<int> polish = alive.mid(0, settings.multiStartPolishCount);
+    FidelityLevel full;
+    full.options = finalSolverOptions(settings);
+    if(!settings.cancellation.isCancelled()) runBatch(polish, QVector<FidelityLevel>(1, full), settings.maxIterations());
+
+    // 结果取精修后 MSE 最小者，计数与统计为全部起点之和
+    LMResult best = runs[polish.isEmpty() ? 0 : polish.first()];
+    for(int k : polish) if(runs[k].mse() < best.mse()) best = runs[k];
+    best.counters = FitCounters();
+    best.stats = InversionStats();
+    for(const LMResult& r : runs) { best.counters.merge(r.counters); best.stats.merge(r.stats); }
+    return best;
+}
+
+void FittingWidget::runModelComparison(const QVector<ModelManager::ModelType>& modelTypes, const QVector<QList<FitParameter>>& modelParams,
+                                       double weight, const FitSettings& settings) {
+    const int modelCount = modelTypes.size();
+    // 各模型的拟合线程取自任务的线程池 (未排队时为全局线程池)，每个模型另有一个线程池用于曲线求值。
+    // 线程总数: 任务线程池的线程加上调用线程 (任务队列的工作线程不属于该线程池；全局线程池中运行时调用线程已计入其中)。
+    // 任务队列在其他任务开始或结束时会调整任务线程池的上限，因此每轮分配前重新读取
+    QThreadPool* modelPool = settings.threadPool ? settings.threadPool : QThreadPool::globalInstance();
+    auto totalThreads = [&]() { return qMax(1, modelPool->maxThreadCount() + (settings.threadPool ? 1 : 0)); };
+    QVector<QThreadPool*> pools;
+    QVector<FitSettings> modelSettings(modelCount, settings);
+    for(int m=0; m<modelCount; ++m) {
+        pools.append(new QThreadPool());
+        modelSettings[m].threadPool = pools[m];
+        modelSettings[m].multiStart = false;
+    }
+    // 同时运行的模型数不超过线程总数，每个模型分得 totalThreads / 同时运行数 个线程 (含其拟合线程本身)，
+    // 合计不超过 totalThreads；只分得一个线程时线程池上限为 1，曲线求值在拟合线程中串行进行
+    auto shareCores = [&](const QVector<int>& alive) {
+        const int budget = totalThreads();
+        int concurrent = qBound(1, alive.size(), budget);
+        int share = qMax(1, budget / concurrent - 1);
+        for(int m : alive) pools[m]->setMaxThreadCount(share);
+    };
+
+    QVector<LMResult> runs(modelCount);
+    for(int m=0; m<modelCount; ++m) runs[m].params = FittingParameterChart::toModelParams(modelParams[m]);
+    QVector<int> eliminatedRound(modelCount, 0);
+
+    QAtomicInt finishedRuns(0);
+    const int totalRuns = modelCount * (kModelRounds + 1);
+    LMResult* runData = runs.data(); // 各任务只写自己的元素
+    auto runBatch = [&](QVector<int> indices, bool polish) {
+        shareCores(indices);
+        QtConcurrent::blockingMap(modelPool, indices, [&](int m) {
+            if(settings.cancellation.isCancelled()) return;
+            // 淘汰轮在最低精度下短程迭代；精修以完整精度迭代至收敛
+            QVector<FidelityLevel> ladder(1);
+            if(polish) ladder[0].options = finalSolverOptions(modelSettings[m]);
+            else ladder[0] = fidelityLadder(modelSettings[m]).first();
+            int maxIter = polish ? modelSettings[m].maxIterations() : kModelRoundIterations;
+            LMResult r = runLevenbergMarquardt(modelTypes[m], modelParams[m], runData[m].params, weight, modelSettings[m], ladder, maxIter, false);
+            if(std::get<0>(r.curve).isEmpty() && !std::get<0>(runData[m].curve).isEmpty()) return;
+            r.counters.merge(runData[m].counters);
+            r.stats.merge(runData[m].stats);
+            runData[m] = r;
+            emit sigProgress((finishedRuns.fetchAndAddRelaxed(1) + 1) * 100 / totalRuns);
+        });
+    };
+    auto byMSE = [&](int a, int b) { return runs[a].mse() < runs[b].mse(); };
+
+    // 淘汰轮: MSE 超过当轮最优模型 kModelPruneRatio 倍的模型提前停止，释放的核分给其余模型
+    QVector<int> alive;
+    for(int m=0; m<modelCount; ++m) alive.append(m);
+    for(int round=0; round<kModelRounds && !settings.cancellation.isCancelled(); ++round) {
+        runBatch(alive, false);
+        std::sort(alive.begin(), alive.end(), byMSE);
+        double bestMSE = runs[alive.first()].mse();
+        QVector<int> kept;
+        for(int m : alive) {
+            if(kept.isEmpty() || runs[m].mse() <= kModelPruneRatio * bestMSE) kept.append(m);
+            else eliminatedRound[m] = round + 1;
+        }
+        finishedRuns.fetchAndAddRelaxed((alive.size() - kept.size()) * (kModelRounds - round));
+        alive = kept;
+        emit sigFitLog(QString("多模型对比: 第 %1/%2 轮，保留 %3/%4 个模型，最优 MSE %5 (模型%6)")
+                           .arg(round + 1).arg(kModelRounds).arg(alive.size()).arg(modelCount)
+                           .arg(bestMSE, 0, 'e', 3).arg((int)modelTypes[alive.first()] + 1));
+    }
+    if(!settings.cancellation.isCancelled()) runBatch(alive, true);
+
+    // 全部模型在拟合时间上按完整精度重算曲线与残差，使提前淘汰的模型与精修过的模型在同一精度下比较
+    QVector<ModelComparisonEntry> entries(modelCount);
+    ModelComparisonEntry* entryData = entries.data();
+    InversionStats totalStats;
+    FitCounters totalCounters;
+    if(!settings.cancellation.isCancelled()) {
+        QVector<int> all;
+        for(int m=0; m<modelCount; ++m) all.append(m);
+        shareCores(all);
+        QtConcurrent::blockingMap(modelPool, all, [&](int m) {
+            ModelParams p = runData[m].params;
+            p.updateDerived();
+            InversionStats finalStats;
+            ModelCurveData curve = m_modelManager->calculateTheoreticalCurve(modelTypes[m], p, m_fitTime, finalSolverOptions(modelSettings[m]), &finalStats);
+            runData[m].stats.merge(finalStats);
+            runData[m].counters.curveEvaluations++;
+
+            ModelComparisonEntry& e = entryData[m];
+            e.modelType = modelTypes[m];
+            e.params = modelParams[m];
+            for(FitParameter& fp : e.params) {
+                int id = ModelParams::indexOf(fp.name);
+                if(id >= 0 && p.contains(ModelParams::Id(id))) fp.value = p[ModelParams::Id(id)];
+                if(fp.isFit && id >= 0) e.parameterCount++;
+            }
+            QVector<double> residuals = calculateResiduals(curve, weight);
+            e.residualCount = residuals.size();
+            e.sse = calculateSumSquaredError(residuals);
+            e.eliminatedRound = eliminatedRound[m];
+            e.t = std::get<0>(curve); e.p = std::get<1>(curve); e.d = std::get<2>(curve);
+        });
+        for(const LMResult& r : runs) { totalStats.merge(r.stats); totalCounters.merge(r.counters); }
+    }
+    qDeleteAll(pools);
+
+    // 被取消时各模型的结果不完整，不弹出对比
+    bool cancelled = settings.cancellation.isCancelled();
+    m_comparisonResults = cancelled ? QVector<ModelComparisonEntry>() : entries;
+    if(cancelled) {
+        emit sigFitLog(settings.cancellation.reason() == CancellationToken::DeadlineExpired ? "多模型对比: 已达到时限，已中止" : "多模型对比: 已停止");
+    } else {
+        emit sigInversionStats(totalStats.laplaceEvaluations, totalStats.maxRelativeError, totalStats.interpolationError);
+        emit sigFitLog(QString("多模型对比 | %1 个模型 | ").arg(modelCount) + totalCounters.summary(totalStats.laplaceEvaluations));
+    }
+    QMetaObject::invokeMethod(this, "onModelComparisonFinished");
+}
+
+ModelCurveData FittingWidget::calculateFitCurve(const ModelParams& params, ModelManager::ModelType modelType, const InversionPlan& plan,
+                                                const ModelManager::SolverOptions& options, InversionStats* stats) {
+    if(options.coarseGrid.appliesTo(plan.pointCount()))
+        return m_modelManager->calculateTheoreticalCurve(modelType, params, plan.time(), options, stats);
+    return m_modelManager->calculateTheoreticalCurve(modelType, params, plan, stats, options.parallel);
+}
+
+bool FittingWidget::extendShapeCurve(const ModelParams& params, DimensionlessCurve& shapeCurve, ModelManager::ModelType modelType,
+                                     const ModelManager::SolverOptions& options, InversionStats* stats) {
+    // 补算点的对数密度
+    const int pointsPerDecade = 20;
+    QVector<double> ext = shapeCurve.extensionTimes(params, m_fitTime, pointsPerDecade);
+    if(ext.isEmpty()) return false;
+    shapeCurve.merge(m_modelManager->calculateTheoreticalCurve(modelType, shapeCurve.shapeParams(), ext, options, stats));
+    return true;
+}
+
+ModelCurveData FittingWidget::calculateScaledFitCurve(const ModelParams& params, const DimensionlessCurve& shapeCurve, ModelManager::ModelType modelType,
+                                                      const ModelManager::SolverOptions& options, InversionStats* stats) {
+    ModelCurveData res;
+    if(shapeCurve.evaluate(params, m_fitTime, res)) return res;
+    return m_modelManager->calculateTheoreticalCurve(modelType, params, m_fitTime, options, stats);
+}
+
+void FittingWidget::evaluateCurveTasks(QVector<CurveTask>& tasks, DimensionlessCurve& shapeCurve, ModelManager::ModelType modelType, double weight,
+                                       const InversionPlan& plan, const ModelManager::SolverOptions& options, InversionStats* stats,
+                                       FitCounters* counters) {
+    // 无因次曲线的补算会修改 shapeCurve，先串行完成，并行阶段只读
+    for(const CurveTask& task : tasks) {
+        if(task.scaled && extendShapeCurve(task.params, shapeCurve, modelType, options, stats) && counters) counters->curveEvaluations++;
+    }
+    // 各任务只写自己的结果与统计，求解器与曲线缓存均可并发调用
+    auto evaluate = [&](CurveTask& task) {
+        task.curve = task.scaled ? calculateScaledFitCurve(task.params, shapeCurve, modelType, options, &task.stats)
+                                 : calculateFitCurve(task.params, modelType, plan, options, &task.stats);
+        task.residuals = calculateResiduals(task.curve, weight);
+    };
+    QThreadPool* pool = options.parallel.threadPool ? options.parallel.threadPool : QThreadPool::globalInstance();
+    // 与求解器一致: 线程池上限为 1 时在调用线程中串行计算 (调用线程不另占线程)
+    if(tasks.size() == 1 || pool->maxThreadCount() <= 1) { for(CurveTask& task : tasks) evaluate(task); }
+    else QtConcurrent::blockingMap(pool, tasks, evaluate);
+    if(stats) {
+        for(const CurveTask& task : tasks) stats->merge(task.stats);
+    }
+    // 平移得到的任务不求解模型，不计入曲线求值次数
+    if(counters) {
+        for(const CurveTask& task : tasks) {
+            if(!task.scaled) counters->curveEvaluations++;
+        }
+    }
+}
+
+QVector<double> FittingWidget::calculateResiduals(const ModelParams& params, ModelManager::ModelType modelType, double weight, const InversionPlan& plan,
+                                                  const ModelManager::SolverOptions& options, InversionStats* stats) {
+    if(!m_modelManager || plan.isEmpty()) return QVector<double>();
+    return calculateResiduals(calculateFitCurve(params, modelType, plan, options, stats), weight);
+}
+
+QVector<double> FittingWidget::calculateResiduals(const ModelCurveData& res, double weight) {
     const QVector<double>& pCal = std::get<1>(res); const QVector<double>& dpCal = std::get<2>(res);
     QVector<double> r; double wp = weight; double wd = 1.0 - weight;
-    int count = qMin(m_obsPressure.size(), pCal.size());
+    bool weighted = !m_fitWeight.isEmpty();
+    int count = qMin(m_fitPressure.size(), pCal.size());
     for(int i=0; i<count; ++i) {
-        if(m_obsPressure[i] > 1e-10 && pCal[i] > 1e-10) r.append( (log(m_obsPressure[i]) - log(pCal[i])) * wp ); else r.append(0.0);
+        double wi = weighted ? m_fitWeight[i] : 1.0;
+        if(m_fitPressure[i] > 1e-10 && pCal[i] > 1e-10) r.append( (log(m_fitPressure[i]) - log(pCal[i])) * wp * wi ); else r.append(0.0);
     }
-    int dCount = qMin(m_obsDerivative.size(), dpCal.size()); dCount = qMin(dCount, count);
+    int dCount = qMin(m_fitDerivative.size(), dpCal.size()); dCount = qMin(dCount, count);
     for(int i=0; i<dCount; ++i) {
-        if(m_obsDerivative[i] > 1e-10 && dpCal[i] > 1e-10) r.append( (log(m_obsDerivative[i]) - log(dpCal[i])) * wd ); else r.append(0.0);
+        double wi = weighted ? m_fitWeight[i] : 1.0;
+        if(m_fitDerivative[i] > 1e-10 && dpCal[i] > 1e-10) r.append( (log(m_fitDerivative[i]) - log(dpCal[i])) * wd * wi ); else r.append(0.0);
     }
     return r;
 }
 
-QVector<QVector<double>> FittingWidget::computeJacobian(const QMap<QString, double>& params, const QVector<double>& baseResiduals, const QVector<int>& fitIndices, ModelManager::ModelType modelType, const QList<FitParameter>& currentFitParams, double weight) {
-    int nRes = baseResiduals.size(); int nParams = fitIndices.size();
+QVector<QVector<double>> FittingWidget::computeJacobian(const ModelParams& params, const QVector<double>& baseResiduals, const QVector<ModelParams::Id>& fitIds, ModelManager::ModelType modelType, double weight, const InversionPlan& plan,
+                                                        const ModelManager::SolverOptions& options, DimensionlessCurve& shapeCurve, InversionStats* stats,
+                                                        FitCounters* counters) {
+    bool scaledColumns = shapeCurve.hasSameShape(params);
+    int timeExponent, pressureExponent;
+    int nRes = baseResiduals.size(); int nParams = fitIds.size();
     QVector<QVector<double>> J(nRes, QVector<double>(nParams));
+
+    // 解析列: 拉氏空间参数的偏导数由自动微分一次得到，kf、km、L、Lf 经 M12 = kf/km、LfD = Lf/L 与量纲换算按链式法则组合；
+    // 粗网格模式下残差来自插值曲线，仍按差分计算。裂缝条数为整数、LfD 由 L 与 Lf 派生，也按差分计算
+    bool analytic = scaledColumns && !options.coarseGrid.appliesTo(plan.pointCount());
+    QVector<ModelManager::Sensitivity> directions;
+    QVector<int> directionOf(nParams, -1);
+    QVector<bool> analyticColumn(nParams, false);
+    bool needTimeShift = false;
+    auto addDirection = [&](ModelManager::Sensitivity s) {
+        int index = directions.indexOf(s);
+        if(index < 0) { index = directions.size(); directions.append(s); }
+        return index;
+    };
+    for(int j = 0; j < nParams && analytic; ++j) {
+        ModelParams::Id id = fitIds[j];
+        analyticColumn[j] = true;
+        switch(id) {
+        case ModelParams::Kf: directionOf[j] = addDirection(CompositeModelSolver::SensM12); needTimeShift = true; break;
+        case ModelParams::Km: directionOf[j] = addDirection(CompositeModelSolver::SensM12); break;
+        case ModelParams::L: directionOf[j] = addDirection(CompositeModelSolver::SensLfD); needTimeShift = true; break;
+        case ModelParams::Lf: directionOf[j] = addDirection(CompositeModelSolver::SensLfD); break;
+        case ModelParams::RmD: directionOf[j] = addDirection(CompositeModelSolver::SensRmD); break;
+        case ModelParams::ReD: directionOf[j] = addDirection(CompositeModelSolver::SensReD); break;
+        case ModelParams::Omega1: directionOf[j] = addDirection(CompositeModelSolver::SensOmega1); break;
+        case ModelParams::Omega2: directionOf[j] = addDirection(CompositeModelSolver::SensOmega2); break;
+        case ModelParams::Lambda1: directionOf[j] = addDirection(CompositeModelSolver::SensLambda1); break;
+        case ModelParams::CD: directionOf[j] = addDirection(CompositeModelSolver::SensCD); break;
+        case ModelParams::S: directionOf[j] = addDirection(CompositeModelSolver::SensS); break;
+        case ModelParams::GamaD: directionOf[j] = addDirection(CompositeModelSolver::SensGamaD); break;
+        default:
+            // 纯缩放参数只改变 tD 与压差的换算系数
+            if(CompositeModelSolver::scalingExponents(id, timeExponent, pressureExponent)) { if(timeExponent != 0) needTimeShift = true; }
+            else analyticColumn[j] = false;
+            break;
+        }
+    }
+
+    // 差分列的 2*nParams 个扰动点互相独立，先全部构造出来再一次提交到线程池
+    QVector<CurveTask> tasks;
+    QVector<int> taskOf(nParams, -1);
+    QVector<double> steps(nParams);
+    for(int j = 0; j < nParams; ++j) {
+        if(analyticColumn[j]) continue;
+        ModelParams::Id id = fitIds[j];
+        double val = params[id]; bool isLog = (val > 1e-12 && !ModelParams::isLinearScale(id));
+        double h; ModelParams pPlus = params; ModelParams pMinus = params;
+        if(isLog) { h = 0.01; double valLog = log10(val); pPlus.set(id, pow(10.0, valLog + h)); pMinus.set(id, pow(10.0, valLog - h)); }
+        else { h = 1e-4; pPlus.set(id, val + h); pMinus.set(id, val - h); }
+        if(id == ModelParams::L || id == ModelParams::Lf) { pPlus.updateDerived(); pMinus.updateDerived(); }
+        // 纯缩放参数: 扰动后的曲线是无因次曲线的平移，插值即可
+        bool scaled = scaledColumns && CompositeModelSolver::scalingExponents(id, timeExponent, pressureExponent);
+        taskOf[j] = tasks.size();
+        tasks.append(CurveTask(pPlus, scaled));
+        tasks.append(CurveTask(pMinus, scaled));
+        steps[j] = h;
+    }
+    // 时间换算系数 c 的偏导数: ∂P/∂ln c 即压力导数，∂dP/∂ln c 由无因次曲线沿 ln tD 平移 ±shiftStep 差分得到 (经 Ct 改变 c)
+    const double shiftStep = 0.01;
+    int shiftTask = -1;
+    if(needTimeShift) {
+        ModelParams pPlus = params; ModelParams pMinus = params;
+        double ct = params[ModelParams::Ct];
+        pPlus.set(ModelParams::Ct, ct * std::exp(-shiftStep));
+        pMinus.set(ModelParams::Ct, ct * std::exp(shiftStep));
+        shiftTask = tasks.size();
+        tasks.append(CurveTask(pPlus, true));
+        tasks.append(CurveTask(pMinus, true));
+    }
+    if(!tasks.isEmpty()) evaluateCurveTasks(tasks, shapeCurve, modelType, weight, plan, options, stats, counters);
+
     for(int j = 0; j < nParams; ++j) {
-        int idx = fitIndices[j]; QString pName = currentFitParams[idx].name;
-        double val = params.value(pName); bool isLog = (val > 1e-12 && pName != "S" && pName != "nf");
-        double h; QMap<QString, double> pPlus = params; QMap<QString, double> pMinus = params;
-        if(isLog) { h = 0.01; double valLog = log10(val); pPlus[pName] = pow(10.0, valLog + h); pMinus[pName] = pow(10.0, valLog - h); }
-        else { h = 1e-4; pPlus[pName] = val + h; pMinus[pName] = val - h; }
-        auto updateDeps = [](QMap<QString,double>& map) { if(map.contains("L") && map.contains("Lf") && map["L"] > 1e-9) map["LfD"] = map["Lf"] / map["L"]; };
-        if(pName == "L" || pName == "Lf") { updateDeps(pPlus); updateDeps(pMinus); }
-        QVector<double> rPlus = calculateResiduals(pPlus, modelType, weight);
-        QVector<double> rMinus = calculateResiduals(pMinus, modelType, weight);
+        if(taskOf[j] < 0) continue;
+        const QVector<double>& rPlus = tasks[taskOf[j]].residuals;
+        const QVector<double>& rMinus = tasks[taskOf[j] + 1].residuals;
+        double h = steps[j];
         if(rPlus.size() == nRes && rMinus.size() == nRes) {
             for(int i=0; i<nRes; ++i) J[i][j] = (rPlus[i] - rMinus[i]) / (2.0 * h);
         }
     }
+    if(!analyticColumn.contains(true)) return J;
+
+    ModelManager::CurveSensitivity sens;
+    if(!directions.isEmpty()) sens = m_modelManager->calculateSensitivity(modelType, params, plan, directions, stats, options.parallel);
+    const ModelCurveData base = directions.isEmpty() ? calculateFitCurve(params, modelType, plan, options, stats) : sens.curve;
+    if(counters) counters->curveEvaluations++;
+    const QVector<double>& P = std::get<1>(base);
+    const QVector<double>& D = std::get<2>(base);
+    int nPoints = P.size();
+    // 对 ln c 与 ln(压力换算系数) 的偏导数
+    QVector<double> timeP = D, timeD(nPoints, 0.0);
+    if(shiftTask >= 0) {
+        const QVector<double>& dPlus = std::get<2>(tasks[shiftTask].curve);
+        const QVector<double>& dMinus = std::get<2>(tasks[shiftTask + 1].curve);
+        for(int k=0; k<qMin(nPoints, qMin(dPlus.size(), dMinus.size())); ++k) timeD[k] = (dPlus[k] - dMinus[k]) / (2.0 * shiftStep);
+    }
+
+    double M12 = params[ModelParams::Kf] / params[ModelParams::Km];
+    for(int j = 0; j < nParams; ++j) {
+        if(!analyticColumn[j]) continue;
+        ModelParams::Id id = fitIds[j];
+        double val = params[id];
+        QVector<double> gP(nPoints, 0.0), gD(nPoints, 0.0);
+        const QVector<double>* sP = directionOf[j] >= 0 ? &sens.pressure[directionOf[j]] : nullptr;
+        const QVector<double>* sD = directionOf[j] >= 0 ? &sens.derivative[directionOf[j]] : nullptr;
+        for(int k = 0; k < nPoints; ++k) {
+            switch(id) {
+            case ModelParams::Kf: // M12 ∝ kf, c ∝ kf, 压力换算系数 ∝ 1/kf
+                gP[k] = (M12 * (*sP)[k] + timeP[k] - P[k]) / val;
+                gD[k] = (M12 * (*sD)[k] + timeD[k] - D[k]) / val;
+                break;
+            case ModelParams::Km: // M12 ∝ 1/km
+                gP[k] = -M12 * (*sP)[k] / val;
+                gD[k] = -M12 * (*sD)[k] / val;
+                break;
+            case ModelParams::L: // LfD ∝ 1/L, c ∝ 1/L^2
+                gP[k] = (-params[ModelParams::LfD] * (*sP)[k] - 2.0 * timeP[k]) / val;
+                gD[k] = (-params[ModelParams::LfD] * (*sD)[k] - 2.0 * timeD[k]) / val;
+                break;
+            case ModelParams::Lf: // LfD = Lf / L
+                gP[k] = (*sP)[k] / params[ModelParams::L];
+                gD[k] = (*sD)[k] / params[ModelParams::L];
+                break;
+            default:
+                if(sP) {
+                    gP[k] = (*sP)[k];
+                    gD[k] = (*sD)[k];
+                } else {
+                    CompositeModelSolver::scalingExponents(id, timeExponent, pressureExponent);
+                    gP[k] = (timeExponent * timeP[k] + pressureExponent * P[k]) / val;
+                    gD[k] = (timeExponent * timeD[k] + pressureExponent * D[k]) / val;
+                }
+                break;
+            }
+        }
+        // 与差分列一致: 对数尺度参数的列为对 log10(θ) 的偏导数
+        bool isLog = (val > 1e-12 && !ModelParams::isLinearScale(id));
+        QVector<double> column = calculateResidualDerivative(base, gP, gD, weight, isLog ? val * std::log(10.0) : 1.0);
+        if(column.size() == nRes) {
+            for(int i=0; i<nRes; ++i) J[i][j] = column[i];
+        }
+    }
     return J;
 }
 
+QVector<double> FittingWidget::calculateResidualDerivative(const ModelCurveData& res, const QVector<double>& pressureSens,
+                                                           const QVector<double>& derivativeSens, double weight, double factor) {
+    // 与 calculateResiduals 的排列与有效性判断一致: r = (ln obs - ln cal) * w => ∂r = -w * ∂cal / cal
+    const QVector<double>& pCal = std::get<1>(res); const QVector<double>& dpCal = std::get<2>(res);
+    QVector<double> r; double wp = weight; double wd = 1.0 - weight;
+    bool weighted = !m_fitWeight.isEmpty();
+    int count = qMin(m_fitPressure.size(), pCal.size());
+    for(int i=0; i<count; ++i) {
+        double wi = weighted ? m_fitWeight[i] : 1.0;
+        if(m_fitPressure[i] > 1e-10 && pCal[i] > 1e-10) r.append( -wp * wi * factor * pressureSens[i] / pCal[i] ); else r.append(0.0);
+    }
+    int dCount = qMin(m_fitDerivative.size(), dpCal.size()); dCount = qMin(dCount, count);
+    for(int i=0; i<dCount; ++i) {
+        double wi = weighted ? m_fitWeight[i] : 1.0;
+        if(m_fitDerivative[i] > 1e-10 && dpCal[i] > 1e-10) r.append( -wd * wi * factor * derivativeSens[i] / dpCal[i] ); else r.append(0.0);
+    }
+    return r;
+}
+
 QVector<double> FittingWidget::solveLinearSystem(const QVector<QVector<double>>& A, const QVector<double>& b) {
     int n = b.size(); if (n == 0) return QVector<double>();
     Eigen::MatrixXd matA(n, n); Eigen::VectorXd vecB(n);
@@ -702,15 +1627,16 @@ double FittingWidget::calculateSumSquaredError(const QVector<double>& residuals)
     double sse = 0.0; for(double v : residuals) sse += v*v; return sse;
 }
 
-void FittingWidget::onIterationUpdate(double err, const QMap<QString,double>& p,
+void FittingWidget::onIterationUpdate(double err, const ModelParams& p,
                                       const QVector<double>& t, const QVector<double>& p_curve, const QVector<double>& d_curve) {
     ui->label_Error->setText(QString("误差(MSE): %1").arg(err, 0, 'e', 3));
 
     ui->tableParams->blockSignals(true);
     for(int i=0; i<ui->tableParams->rowCount(); ++i) {
         QString key = ui->tableParams->item(i, 1)->data(Qt::UserRole).toString(); // key在第1列(参数名)
-        if(p.contains(key)) {
-            double val = p[key];
+        int id = ModelParams::indexOf(key);
+        if(id >= 0 && p.contains(ModelParams::Id(id))) {
+            double val = p[ModelParams::Id(id)];
             ui->tableParams->item(i, 2)->setText(QString::number(val, 'g', 5)); // 数值在第2列
         }
     }
@@ -719,9 +1645,141 @@ void FittingWidget::onIterationUpdate(double err, const QMap<QString,double>& p,
     plotCurves(t, p_curve, d_curve, true);
 }
 
-void FittingWidget::onFitFinished() { m_isFitting = false; ui->btnRunFit->setEnabled(true); QMessageBox::information(this, "完成", "拟合完成。"); }
+void FittingWidget::onInversionStats(int evaluations, double maxRelativeError, double interpolationError) {
+    QString text = QString("拉氏空间求值: %1 次 | 估计相对误差: %2").arg(evaluations).arg(maxRelativeError, 0, 'e', 2);
+    if(interpolationError > 0.0) text += QString(" | 插值误差: %1").arg(interpolationError, 0, 'e', 2);
+    ui->label_InversionInfo->setText(text);
+}
+
+void FittingWidget::onFitLog(const QString& text) {
+    ui->label_FitLog->setText("拟合日志: " + text);
+}
 
-void FittingWidget::plotCurves(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d, bool isModel) {
+void FittingWidget::onProgressFrame() {
+    if(!m_progressBuffer.take()) return;
+    const FitProgressFrame& frame = m_progressBuffer.readSlot();
+    ui->progressBar->setValue(frame.progress);
+    onInversionStats(frame.stats.laplaceEvaluations, frame.stats.maxRelativeError, frame.stats.interpolationError);
+    onFitLog(frame.logText());
+    onIterationUpdate(frame.error, frame.params, frame.t, frame.p, frame.d);
+}
+
+ModelManager::SolverOptions FittingWidget::finalSolverOptions(const FitSettings& settings) {
+    ModelManager::SolverOptions options = ModelManager::SolverOptions::highPrecision(settings.inversionMethod);
+    options.coarseGrid.enabled = settings.coarseGrid;
+    options.parallel.threadPool = settings.threadPool;
+    options.parallel.cancellation = settings.cancellation;
+    return options;
+}
+
+QVector<FittingWidget::FidelityLevel> FittingWidget::fidelityLadder(const FitSettings& settings) {
+    ModelManager::SolverOptions low = ModelManager::SolverOptions::lowPrecision(settings.inversionMethod);
+    ModelManager::SolverOptions high = finalSolverOptions(settings);
+    low.coarseGrid.enabled = settings.coarseGrid;
+    low.parallel.threadPool = settings.threadPool;
+    low.parallel.cancellation = settings.cancellation;
+
+    QVector<FidelityLevel> ladder;
+    if(!settings.progressiveFidelity) {
+        FidelityLevel single;
+        single.options = low;
+        ladder.append(single);
+        return ladder;
+    }
+    // 第 1 级: 低阶反演、宽松积分容差；观测点足够多时强制粗网格并放宽插值误差限
+    FidelityLevel coarse;
+    coarse.options = low;
+    coarse.options.quadratureTolerance = 1e-3;
+    coarse.options.coarseGrid.enabled = true;
+    coarse.options.coarseGrid.tolerance = 1e-2;
+    coarse.promoteBelow = 5e-2;
+    // 第 2 级: 中间阶数，积分容差收紧一个数量级
+    FidelityLevel medium;
+    medium.options = low;
+    medium.options.inversionOrder = LaplaceInversion::normalizeOrder(settings.inversionMethod, (low.inversionOrder + high.inversionOrder) / 2);
+    medium.options.quadratureTolerance = 1e-4;
+    medium.promoteBelow = 1e-2;
+    // 第 3 级: 与最终曲线相同的完整精度
+    FidelityLevel full;
+    full.options = high;
+    ladder << coarse << medium << full;
+    return ladder;
+}
+
+QString FittingWidget::FitSettings::optimizerName(Optimizer optimizer) {
+    switch(optimizer) {
+    case ClassicLM: return "经典 LM";
+    case NielsenLM: return "Nielsen 阻尼 LM";
+    case GeodesicLM: return "测地线加速 LM";
+    case DoglegTrustRegion: return "狗腿信赖域";
+    default: return QString();
+    }
+}
+
+void FittingWidget::FitCounters::merge(const FitCounters& other) {
+    iterations += other.iterations;
+    jacobianEvaluations += other.jacobianEvaluations;
+    broydenUpdates += other.broydenUpdates;
+    curveEvaluations += other.curveEvaluations;
+}
+
+QString FittingWidget::FitCounters::summary(int laplaceEvaluations) const {
+    return QString("迭代 %1 次 | 雅可比: 完整计算 %2 次, Broyden 更新 %3 次 | 理论曲线求值 %4 次 | 拉氏空间求值 %5 次")
+        .arg(iterations).arg(jacobianEvaluations).arg(broydenUpdates).arg(curveEvaluations).arg(laplaceEvaluations);
+}
+
+QString FittingWidget::FitProgressFrame::logText() const {
+    QString text = FitSettings::optimizerName(optimizer);
+    if(levelCount > 1) text += QString(" | 精度等级 %1/%2").arg(level + 1).arg(levelCount);
+    return text + " | " + counters.summary(stats.laplaceEvaluations);
+}
+
+void FittingWidget::onStartUpdated(int index, double error, const ModelParams& params, const QVector<double>& t,
+                                   const QVector<double>& p_curve, const QVector<double>& d_curve) {
+    if(!m_startGraphs.contains(index)) {
+        QCPGraph* gp = m_plot->addGraph(); gp->setPen(QPen(QColor(255, 0, 0, 60), 1)); gp->removeFromLegend();
+        QCPGraph* gd = m_plot->addGraph(); gd->setPen(QPen(QColor(0, 0, 255, 60), 1)); gd->removeFromLegend();
+        m_startGraphs.insert(index, qMakePair(gp, gd));
+    }
+    setCurveData(m_startGraphs[index].first, m_startGraphs[index].second, t, p_curve, d_curve);
+    // 目前最优的起点同时刷新参数表与主理论曲线
+    if(m_bestStartError <= 0.0 || error < m_bestStartError) {
+        m_bestStartError = error;
+        onIterationUpdate(error, params, t, p_curve, d_curve);
+    } else {
+        m_plot->replot();
+    }
+}
+
+void FittingWidget::clearStartCurves() {
+    for(const auto& graphs : m_startGraphs) {
+        m_plot->removeGraph(graphs.first);
+        m_plot->removeGraph(graphs.second);
+    }
+    m_startGraphs.clear();
+    m_bestStartError = 0.0;
+    m_plot->replot();
+}
+
+void FittingWidget::onFitFinished() { m_progressTimer.stop(); m_isFitting = false; ui->btnRunFit->setEnabled(true); ui->btnFitAllModels->setEnabled(true); clearStartCurves(); QMessageBox::information(this, "完成", "拟合完成。"); }
+
+void FittingWidget::onModelComparisonFinished() {
+    m_isFitting = false;
+    ui->btnRunFit->setEnabled(true); ui->btnFitAllModels->setEnabled(true);
+    if(m_comparisonResults.isEmpty()) return;
+
+    ModelComparisonDialog dlg(m_comparisonResults, m_obsTime, m_obsPressure, m_obsDerivative, this);
+    if(dlg.exec() != QDialog::Accepted || dlg.selectedIndex() < 0) return;
+
+    // 采用所选模型: 切换模型并载入其拟合参数
+    const ModelComparisonEntry& chosen = dlg.entries()[dlg.selectedIndex()];
+    m_currentModelType = chosen.modelType;
+    m_paramChart->setParameters(chosen.params);
+    ui->btn_modelSelect->setText("当前: " + ModelManager::getModelTypeName(chosen.modelType));
+    updateModelCurve();
+}
+
+void FittingWidget::setCurveData(QCPGraph* pressureGraph, QCPGraph* derivativeGraph, const QVector<double>& t, const QVector<double>& p, const QVector<double>& d) {
     QVector<double> vt, vp, vd;
     for(int i=0; i<t.size(); ++i) {
         if(t[i]>1e-8 && p[i]>1e-8) {
@@ -729,9 +1787,13 @@ void FittingWidget::plotCurves(const QVector<double>& t, const QVector<double>&
             if(i<d.size() && d[i]>1e-8) vd<<d[i]; else vd<<1e-10;
         }
     }
+    pressureGraph->setData(vt, vp); derivativeGraph->setData(vt, vd);
+}
+
+void FittingWidget::plotCurves(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d, bool isModel) {
     if(isModel) {
-        m_plot->graph(2)->setData(vt, vp); m_plot->graph(3)->setData(vt, vd);
-        if (m_obsTime.isEmpty() && !vt.isEmpty()) {
+        setCurveData(m_plot->graph(2), m_plot->graph(3), t, p, d);
+        if (m_obsTime.isEmpty() && !m_plot->graph(2)->data()->isEmpty()) {
             m_plot->rescaleAxes();
             if(m_plot->xAxis->range().lower<=0) m_plot->xAxis->setRangeLower(1e-3);
             if(m_plot->yAxis->range().lower<=0) m_plot->yAxis->setRangeLower(1e-3);
@@ -15,8 +15,14 @@
 #include <QMap>
 #include <QVector>
 #include <QFutureWatcher>
+#include <QTimer>
+#include <QPointer>
+#include <functional>
 #include <QJsonObject>
 #include "modelmanager.h"
+#include "dimensionlesscurve.h"
+#include "logtimeresampler.h"
+#include "latestvaluebuffer.h"
 #include "mousezoom.h"
 #include "chartsetting1.h"
 
@@ -24,8 +30,10 @@
 #include "fittingparameterchart.h"
 #include "fittingobserveddata.h"
 #include "paramselectdialog.h"
+#include "modelcomparisondialog.h"
 
 namespace Ui { class FittingWidget; }
+class FittingJobScheduler;
 
 class FittingWidget : public QWidget
 {
@@ -38,6 +46,11 @@ public:
     // 设置模型管理器
     void setModelManager(ModelManager* m);
 
+    // 设置拟合任务调度器 (各分析页共用)；未设置时拟合直接在全局线程池中运行
+    void setJobScheduler(FittingJobScheduler* scheduler);
+    // 分析页名称 (显示在任务队列中)
+    void setAnalysisName(const QString& name);
+
     // 设置观测数据（时间、压力、导数）
     void setObservedData(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d);
 
@@ -54,9 +67,15 @@ signals:
     // 拟合完成信号
     void fittingCompleted(ModelManager::ModelType modelType, const QMap<QString, double>& parameters);
     // 迭代更新信号（用于刷新曲线和误差显示）
-    void sigIterationUpdated(double error, QMap<QString, double> currentParams, QVector<double> t, QVector<double> p, QVector<double> d);
+    void sigIterationUpdated(double error, ModelParams currentParams, QVector<double> t, QVector<double> p, QVector<double> d);
     // 进度信号
     void sigProgress(int progress);
+    // 数值反演统计信号 (累计拉氏空间求值次数、最终曲线的估计相对误差)
+    void sigInversionStats(int evaluations, double maxRelativeError, double interpolationError);
+    // 拟合日志信号 (迭代次数、雅可比矩阵的计算方式与理论曲线求值次数)
+    void sigFitLog(const QString& text);
+    // 多起点搜索中某个起点完成一轮求解 (index 为起点序号)
+    void sigStartUpdated(int index, double error, ModelParams params, QVector<double> t, QVector<double> p, QVector<double> d);
     // 请求保存信号
     void sigRequestSave();
 
@@ -64,6 +83,7 @@ private slots:
     // UI 按钮槽函数
     void on_btnLoadData_clicked();      // 加载数据
     void on_btnRunFit_clicked();        // 开始拟合
+    void on_btnFitAllModels_clicked();  // 多模型对比拟合
     void on_btnStop_clicked();          // 停止拟合
     void on_btnImportModel_clicked();   // 刷新曲线
     void on_btnExportData_clicked();    // 导出参数
@@ -78,9 +98,16 @@ private slots:
     void on_btnExportReport_clicked();  // 导出报告
 
     // 内部逻辑槽函数
-    void onIterationUpdate(double err, const QMap<QString,double>& p, const QVector<double>& t, const QVector<double>& p_curve, const QVector<double>& d_curve);
+    void onIterationUpdate(double err, const ModelParams& p, const QVector<double>& t, const QVector<double>& p_curve, const QVector<double>& d_curve);
     void onFitFinished();
+    void onModelComparisonFinished(); // 多模型对比结束，弹出对比结果
     void onSliderWeightChanged(int value); // 权重滑块改变
+    void onInversionStats(int evaluations, double maxRelativeError, double interpolationError); // 显示反演统计
+    void onFitLog(const QString& text); // 显示拟合日志
+    void onProgressFrame(); // 定时取出单起点拟合的最新进度帧并刷新参数表、曲线与日志
+    void onJobDiscarded(int jobId); // 排队中的拟合任务被取消，恢复界面状态
+    void onStartUpdated(int index, double error, const ModelParams& params, const QVector<double>& t,
+                        const QVector<double>& p_curve, const QVector<double>& d_curve); // 绘制多起点的候选曲线
 
 private:
     Ui::FittingWidget *ui;
@@ -98,11 +125,30 @@ private:
     QVector<double> m_obsPressure;
     QVector<double> m_obsDerivative;
 
+    // 拟合使用的数据: 观测数据按对数时间重采样后的代表点 (未启用时即观测数据)，拟合开始前在界面线程准备，拟合过程中只读
+    QVector<double> m_fitTime;
+    QVector<double> m_fitPressure;
+    QVector<double> m_fitDerivative;
+    QVector<double> m_fitWeight; // 残差权重 sqrt(点数 / 平均点数)，为空表示等权
+
     // 拟合控制标志
     bool m_isFitting;
-    bool m_stopRequested;
+    CancellationToken m_cancelToken; // 停止按钮的取消令牌 (每次拟合新建)；拟合时限由其派生令牌在任务开始运行时计时
     QFutureWatcher<void> m_watcher;
 
+    // 拟合任务调度 (为空时不排队)、本页最近一次提交的任务编号与分析页名称
+    QPointer<FittingJobScheduler> m_jobScheduler;
+    int m_jobId;
+    QString m_analysisName;
+
+    // 多起点搜索的候选曲线 (起点序号 -> 压力、导数曲线) 与已显示的最优 MSE
+    QMap<int, QPair<QCPGraph*, QCPGraph*>> m_startGraphs;
+    double m_bestStartError;
+    // 移除多起点的候选曲线
+    void clearStartCurves();
+    // 多模型对比的结果 (拟合线程写入后通过 onModelComparisonFinished 交给界面线程)
+    QVector<ModelComparisonEntry> m_comparisonResults;
+
     // 初始化绘图控件配置
     void setupPlot();
     // 初始化默认模型状态
@@ -110,14 +156,158 @@ private:
     // 根据当前参数更新理论曲线
     void updateModelCurve();
 
+    // 自动拟合的设置 (由界面读取后按值传入拟合线程)
+    struct FitSettings {
+        // 优化算法: 经典 LM (阻尼因子按 10 倍增减，成批尝试)、Nielsen 阻尼 LM、Nielsen 阻尼 + 测地线加速 LM、狗腿信赖域
+        enum Optimizer { ClassicLM, NielsenLM, GeodesicLM, DoglegTrustRegion, OptimizerCount };
+
+        LaplaceInversion::Method inversionMethod; // 拉氏数值反演方法
+        Optimizer optimizer;                      // 优化算法
+        bool coarseGrid;                          // 粗网格插值
+        bool progressiveFidelity;                 // 渐进精度: 迭代初期用低阶反演、宽松积分容差与粗网格，随收敛逐级提高
+        bool multiStart;                          // 多起点全局搜索
+        int multiStartCount;                      // 起点数 (含参数表中的初值)
+        int multiStartPolishCount;                // 以完整精度精修的起点数
+        quint32 multiStartSeed;                   // 拉丁超立方抽样的随机种子
+        bool broydenUpdate;                       // 拟牛顿模式: 接受步之后用 Broyden 秩一更新代替重新计算雅可比矩阵
+        int jacobianRefreshInterval;              // 拟牛顿模式下完整重算雅可比矩阵的迭代间隔
+        QThreadPool* threadPool;                  // 曲线求值与反演并行所用的线程池，为空时使用全局线程池 (多模型对比时各模型独占一份)
+        LogTimeResampler::Options resampling;     // 观测数据的对数时间重采样
+        bool countWeighting;                      // 重采样后按各代表点的原始点数加权残差 (否则各代表点等权)
+        int timeLimitSeconds;                     // 拟合时限 (秒)，0 表示不限时
+        CancellationToken cancellation;           // 停止或超时时取消，传入求解器的反演循环与影响系数积分
+
+        FitSettings() : inversionMethod(LaplaceInversion::Stehfest), optimizer(ClassicLM), coarseGrid(false), progressiveFidelity(true),
+                        multiStart(false), multiStartCount(16), multiStartPolishCount(3), multiStartSeed(1),
+                        broydenUpdate(false), jacobianRefreshInterval(5), threadPool(nullptr), countWeighting(false), timeLimitSeconds(0) {}
+        static QString optimizerName(Optimizer optimizer);
+        // 经典 LM 每次迭代最多尝试 5 个阻尼因子；其余模式每次迭代只求值一个试探点，迭代上限相应放宽
+        int maxIterations() const { return optimizer == ClassicLM ? 50 : 150; }
+    };
+    // 从界面读取拟合设置 (反演方法、优化算法与各加速选项)
+    FitSettings readFitSettings() const;
+    // 提交拟合任务: 有调度器时排队，按其线程预算运行 (settings.threadPool 为任务独占的线程池)，否则直接在全局线程池中运行
+    void startFitJob(const QString& description, const FitSettings& settings, const std::function<void(const FitSettings&)>& run);
+    // 按设置由观测数据准备拟合数据 (重采样与残差权重)，返回说明文字
+    QString prepareFitData(const FitSettings& settings);
+    // 拟合日志计数
+    struct FitCounters {
+        int iterations;          // LM 迭代次数
+        int jacobianEvaluations; // 完整计算雅可比矩阵的次数
+        int broydenUpdates;      // Broyden 秩一更新的次数
+        int curveEvaluations;    // 理论曲线求值次数 (扰动点、试探步、自动微分与无因次曲线补算)
+
+        FitCounters() : iterations(0), jacobianEvaluations(0), broydenUpdates(0), curveEvaluations(0) {}
+        void merge(const FitCounters& other);
+        QString summary(int laplaceEvaluations) const;
+    };
+    // 单起点拟合的进度帧: 拟合线程在状态变化时写入 m_progressBuffer，只含定长数据与曲线，日志文字由界面线程生成
+    struct FitProgressFrame {
+        double error;
+        ModelParams params;
+        QVector<double> t, p, d; // 当前点的理论曲线 (即残差所用的曲线)
+        int progress;
+        InversionStats stats;
+        FitCounters counters;
+        FitSettings::Optimizer optimizer;
+        int level;               // 当前精度等级 (从 0 计) 与等级数
+        int levelCount;
+
+        FitProgressFrame() : error(0.0), progress(0), optimizer(FitSettings::ClassicLM), level(0), levelCount(1) {}
+        QString logText() const;
+    };
+    // 拟合进度: 拟合线程只写入最新状态，界面定时器按 kProgressFrameMs 的间隔取最新一帧，快速迭代不会堆积事件
+    LatestValueBuffer<FitProgressFrame> m_progressBuffer;
+    QTimer m_progressTimer;
+    // 精度阶梯的一级: 该级的求解选项，接受步的 SSE 相对下降量低于 promoteBelow 时进入下一级
+    struct FidelityLevel {
+        ModelManager::SolverOptions options;
+        double promoteBelow;
+
+        FidelityLevel() : promoteBelow(0.0) {}
+    };
+    // 按拟合设置生成精度阶梯 (最后一级与最终曲线精度相同)；不启用渐进精度时只有低精度一级
+    static QVector<FidelityLevel> fidelityLadder(const FitSettings& settings);
+    // 最终曲线 (及精度阶梯最高一级) 的求解选项
+    static ModelManager::SolverOptions finalSolverOptions(const FitSettings& settings);
+
+    // 残差均方误差低于该阈值即认为拟合收敛
+    static constexpr double kTargetMSE = 3e-3;
+    // 拟合进度的刷新间隔 (毫秒，约 20 帧/秒)
+    static constexpr int kProgressFrameMs = 50;
+    // 多起点搜索: 探索轮数、每轮迭代次数，MSE 超过当轮最优值该倍数的起点被淘汰
+    static constexpr int kMultiStartRounds = 3;
+    static constexpr int kMultiStartRoundIterations = 5;
+    static constexpr double kMultiStartPruneRatio = 3.0;
+    // 多模型对比: 淘汰轮数、每轮迭代次数，MSE 超过当轮最优模型该倍数的模型提前停止
+    static constexpr int kModelRounds = 2;
+    static constexpr int kModelRoundIterations = 8;
+    static constexpr double kModelPruneRatio = 10.0;
+
+    // 单个起点的一次 LM 求解结果
+    struct LMResult {
+        ModelParams params;
+        double sse;
+        int residualCount;
+        ModelCurveData curve; // 结束时所在精度下拟合时间上的理论曲线
+        InversionStats stats;
+        FitCounters counters;
+
+        LMResult() : sse(1e15), residualCount(0) {}
+        double mse() const { return residualCount > 0 ? sse / residualCount : sse; }
+    };
+
     // 优化算法相关函数 (Levenberg-Marquardt)
-    void runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight);
-    void runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight);
+    void runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight, const FitSettings& settings);
+    void runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight, const FitSettings& settings);
+    // 从 start 出发按精度阶梯 ladder 迭代至多 maxIter 次；interactive 为 true 时把每步的曲线、统计与计数写入 m_progressBuffer
+    LMResult runLevenbergMarquardt(ModelManager::ModelType modelType, const QList<FitParameter>& params, const ModelParams& start, double weight,
+                                   const FitSettings& settings, const QVector<FidelityLevel>& ladder, int maxIter, bool interactive);
+    // 多起点全局搜索: 拉丁超立方起点并行做低精度短程 LM，逐轮淘汰落后者，最优的几个以完整精度精修
+    LMResult runMultiStartSearch(ModelManager::ModelType modelType, const QList<FitParameter>& params, double weight, const FitSettings& settings);
+    // 多模型对比: 各模型在各自的线程池中并行拟合 (核数按存活模型均分)，逐轮淘汰明显落后的模型，
+    // 其余以完整精度精修；结果写入 m_comparisonResults
+    void runModelComparison(const QVector<ModelManager::ModelType>& modelTypes, const QVector<QList<FitParameter>>& modelParams,
+                            double weight, const FitSettings& settings);
+
+    // 拟合用理论曲线: options 启用粗网格时在自适应网格上计算后插值到拟合时间，否则在反演计划 plan 上逐点计算
+    ModelCurveData calculateFitCurve(const ModelParams& params, ModelManager::ModelType modelType, const InversionPlan& plan,
+                                     const ModelManager::SolverOptions& options, InversionStats* stats = nullptr);
+    // 拟合时间按 params 平移后超出 shapeCurve 的覆盖范围时，按其形状参数补算两端并合并 (有补算时返回 true)
+    bool extendShapeCurve(const ModelParams& params, DimensionlessCurve& shapeCurve, ModelManager::ModelType modelType,
+                          const ModelManager::SolverOptions& options, InversionStats* stats = nullptr);
+    // 由无因次曲线平移得到拟合用理论曲线 (params 与 shapeCurve 只在纯缩放参数上不同)；仍未覆盖时直接计算
+    ModelCurveData calculateScaledFitCurve(const ModelParams& params, const DimensionlessCurve& shapeCurve, ModelManager::ModelType modelType,
+                                           const ModelManager::SolverOptions& options, InversionStats* stats = nullptr);
+
+    // 一次曲线求值任务 (雅可比扰动点或试探步)，结果与统计只写入本任务
+    struct CurveTask {
+        ModelParams params;
+        bool scaled; // 由无因次曲线平移得到
+        ModelCurveData curve;
+        QVector<double> residuals;
+        InversionStats stats;
 
-    // 计算残差
-    QVector<double> calculateResiduals(const QMap<QString, double>& params, ModelManager::ModelType modelType, double weight);
-    // 计算雅可比矩阵
-    QVector<QVector<double>> computeJacobian(const QMap<QString, double>& params, const QVector<double>& residuals, const QVector<int>& fitIndices, ModelManager::ModelType modelType, const QList<FitParameter>& currentFitParams, double weight);
+        CurveTask() : scaled(false) {}
+        CurveTask(const ModelParams& p, bool s) : params(p), scaled(s) {}
+    };
+    // 在线程池中并行计算各任务的曲线与残差，统计按任务顺序并入 stats
+    void evaluateCurveTasks(QVector<CurveTask>& tasks, DimensionlessCurve& shapeCurve, ModelManager::ModelType modelType, double weight,
+                            const InversionPlan& plan, const ModelManager::SolverOptions& options, InversionStats* stats,
+                            FitCounters* counters = nullptr);
+    // 计算残差 (在拟合时间网格上计算，精度由 plan/options 的反演方法与阶数决定)
+    QVector<double> calculateResiduals(const ModelParams& params, ModelManager::ModelType modelType, double weight, const InversionPlan& plan,
+                                       const ModelManager::SolverOptions& options, InversionStats* stats = nullptr);
+    // 由拟合时间上的理论曲线计算残差 (压力与导数的对数差，按代表点权重加权)
+    QVector<double> calculateResiduals(const ModelCurveData& curve, double weight);
+    // 计算雅可比矩阵 (fitIds 为参与拟合的参数下标)；拉氏空间参数与 kf、km、L、Lf 的列由自动微分的精确偏导数按链式法则得到，
+    // 纯缩放参数的列由量纲换算的幂次得到；其余参数 (裂缝条数等) 与粗网格模式下按差分计算，扰动点并行求值
+    QVector<QVector<double>> computeJacobian(const ModelParams& params, const QVector<double>& residuals, const QVector<ModelParams::Id>& fitIds, ModelManager::ModelType modelType, double weight, const InversionPlan& plan,
+                                             const ModelManager::SolverOptions& options, DimensionlessCurve& shapeCurve, InversionStats* stats = nullptr,
+                                             FitCounters* counters = nullptr);
+    // 由理论曲线及其偏导数计算残差的偏导数 (与 calculateResiduals 的排列一致，各项乘以 factor)
+    QVector<double> calculateResidualDerivative(const ModelCurveData& curve, const QVector<double>& pressureSens,
+                                                const QVector<double>& derivativeSens, double weight, double factor);
     // 求解线性方程组 (Eigen)
     QVector<double> solveLinearSystem(const QVector<QVector<double>>& A, const QVector<double>& b);
     // 计算平方误差和
@@ -125,6 +315,8 @@ private:
 
     // 获取图表 Base64 字符串用于报告
     QString getPlotImageBase64();
+    // 按绘图规则 (去掉非正值) 设置一对压力/导数曲线的数据
+    void setCurveData(QCPGraph* pressureGraph, QCPGraph* derivativeGraph, const QVector<double>& t, const QVector<double>& p, const QVector<double>& d);
     // 绘制曲线
     void plotCurves(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d, bool isModel);
 };